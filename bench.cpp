@@ -0,0 +1,68 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+#include "tcp_load_generator.h"
+
+/*
+ * xsckt_bench - load an echo server already listening, e.g. xsckt built with SERVER and one of its models
+ *
+ *	-a addr		server address, default 127.0.0.1
+ *	-p port		server port, default 5555
+ *	-c count	connections, default 16
+ *	-s bytes	message size, default 64
+ *	-d depth	closed loop - messages in flight per connection, default 1
+ *	-r rate		open loop - messages a second per connection, default 0 (closed loop)
+ *	-t seconds	measured time, default 10
+ *	-w seconds	warm up before measuring, default 1
+ */
+
+static void usage() {
+	std::cerr << "usage: xsckt_bench [-a addr] [-p port] [-c connections] [-s message_size] [-d depth] [-r rate] [-t seconds] [-w warmup]\n";
+}
+
+int main(int argc, char* argv[]) {
+
+	xsckt::tcp_load_generator::options_t options;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strlen(argv[i]) != 2 || argv[i][0] != '-' || i + 1 == argc) {
+			usage();
+			return 1;
+		}
+		const char* value = argv[++i];
+		switch (argv[i - 1][1]) {
+		case 'a': options.addr = value; break;
+		case 'p': options.port = static_cast<unsigned short>(std::atoi(value)); break;
+		case 'c': options.connections = std::strtoul(value, nullptr, 10); break;
+		case 's': options.message_size = std::strtoul(value, nullptr, 10); break;
+		case 'd': options.depth = std::strtoul(value, nullptr, 10); break;
+		case 'r': options.rate = std::atof(value); break;
+		case 't': options.seconds = std::atof(value); break;
+		case 'w': options.warmup = std::atof(value); break;
+		default:
+			usage();
+			return 1;
+		}
+	}
+
+#ifdef WIN32
+	std::cout << xsckt::startup() << "\n";
+#endif
+
+	int status = 0;
+	try {
+		xsckt::tcp_load_generator generator(options);
+		generator.run();
+	}
+	catch (std::runtime_error& e) {
+		std::cerr << e.what() << "\n";
+		status = 1;
+	}
+
+#ifdef WIN32
+	xsckt::cleanup();
+#endif
+	return status;
+
+}
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "socket_factory.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+#ifdef __cpp_concepts
+
+    /**
+     * @brief bsd_socket - a socket with every bsd_interface operation, called directly, such as base_socket
+     */
+    template<typename socket_type>
+    concept bsd_socket = requires(socket_type& sckt, address_t& address, port_t port, char* in, const char* out, size_t n,
+        const std::string& text, const const_buffer* views, const mutable_buffer* spans, action_t action) {
+        sckt.bind_to(address, port);
+        sckt.listen_to();
+        { sckt.is_listening() } -> std::convertible_to<bool>;
+        { sckt.accept_from() } -> std::convertible_to<sockfd_t>;
+        sckt.connect_to(address, port);
+        sckt.be_non_blocking();
+        { sckt.peek() } -> std::convertible_to<size_t>;
+        { sckt.read(0) } -> std::convertible_to<std::string>;
+        { sckt.write(address, 0) } -> std::convertible_to<long>;
+        { sckt.read(in, n, 0) } -> std::convertible_to<long>;
+        { sckt.write(out, n, 0) } -> std::convertible_to<long>;
+        { sckt.read_from(0) } -> std::convertible_to<std::string>;
+        { sckt.write_back(text, 0) } -> std::convertible_to<long>;
+        { sckt.read_from(in, n, 0) } -> std::convertible_to<long>;
+        { sckt.write_back(out, n, 0) } -> std::convertible_to<long>;
+        { sckt.write_v(views, n, 0) } -> std::convertible_to<long>;
+        { sckt.read_v(spans, n, 0) } -> std::convertible_to<long>;
+        { sckt.write_back_v(views, n, 0) } -> std::convertible_to<long>;
+        { sckt.read_from_v(spans, n, 0) } -> std::convertible_to<long>;
+        { sckt.hostname() } -> std::convertible_to<std::string>;
+        sckt.reset();
+        sckt.stop(action);
+    };
+
+#endif // __cpp_concepts
+
+    /**
+     * @brief The bsd_adapter class puts a socket behind the abstract bsd_interface, for code that has to hold sockets of
+     * different types through one pointer.
+     * @version 0.1
+     * The sockets themselves have no virtual members, so a call on one is a direct call and they carry no vtable pointer.
+     * The adapter adds the vtable and one virtual call per operation back, only where it is used. This one forwards every
+     * operation, so the wrapped type must have them all, as base_socket does, or it fails to compile. Each multi_socket
+     * product has its own specialization below, which forwards the operations of its role.
+     * @note the socket must outlive it
+     */
+    template<typename socket_type>
+    class bsd_adapter final : public bsd_interface {
+
+#ifdef __cpp_concepts
+        static_assert(bsd_socket<socket_type>, "bsd_adapter needs a socket with every bsd_interface operation, e.g. base_socket");
+#endif
+
+    public:
+
+        explicit bsd_adapter(socket_type& sckt) : _sckt(sckt) {}
+
+        void bind_to(address_t& address, port_t port) override {
+            _sckt.bind_to(address, port);
+        }
+
+        void listen_to() override {
+            _sckt.listen_to();
+        }
+
+        bool is_listening() const override {
+            return _sckt.is_listening();
+        }
+
+        sockfd_t accept_from() override {
+            return _sckt.accept_from();
+        }
+
+        void connect_to(address_t& address, port_t port) override {
+            _sckt.connect_to(address, port);
+        }
+
+        void be_non_blocking() override {
+            _sckt.be_non_blocking();
+        }
+
+        size_t peek() const override {
+            return _sckt.peek();
+        }
+
+        std::string read(flag_t flags = 0) const override {
+            return _sckt.read(flags);
+        }
+
+        long write(address_t& buffer, flag_t flags = 0) const override {
+            return _sckt.write(buffer, flags);
+        }
+
+        long read(char* buffer, size_t length, flag_t flags = 0) const override {
+            return _sckt.read(buffer, length, flags);
+        }
+
+        long write(const char* buffer, size_t length, flag_t flags = 0) const override {
+            return _sckt.write(buffer, length, flags);
+        }
+
+        std::string read_from(flag_t flags = 0) override {
+            return _sckt.read_from(flags);
+        }
+
+        long write_back(const std::string& buffer, flag_t flags = 0) override {
+            return _sckt.write_back(buffer, flags);
+        }
+
+        long read_from(char* buffer, size_t length, flag_t flags = 0) override {
+            return _sckt.read_from(buffer, length, flags);
+        }
+
+        long write_back(const char* buffer, size_t length, flag_t flags = 0) override {
+            return _sckt.write_back(buffer, length, flags);
+        }
+
+        long write_v(const const_buffer* buffers, size_t count, flag_t flags = 0) const override {
+            return _sckt.write_v(buffers, count, flags);
+        }
+
+        long read_v(const mutable_buffer* buffers, size_t count, flag_t flags = 0) const override {
+            return _sckt.read_v(buffers, count, flags);
+        }
+
+        long write_back_v(const const_buffer* buffers, size_t count, flag_t flags = 0) override {
+            return _sckt.write_back_v(buffers, count, flags);
+        }
+
+        long read_from_v(const mutable_buffer* buffers, size_t count, flag_t flags = 0) override {
+            return _sckt.read_from_v(buffers, count, flags);
+        }
+
+        std::string hostname() const override {
+            return _sckt.hostname();
+        }
+
+        void reset() override {
+            _sckt.reset();
+        }
+
+        void stop(action_t action) override {
+            _sckt.stop(action);
+        }
+
+        /**
+         * @brief wrapped - the socket itself, for the members bsd_interface does not have
+         */
+        socket_type& wrapped() const {
+            return _sckt;
+        }
+
+    private:
+
+        socket_type& _sckt;
+
+    };
+
+    /**
+     * @brief The bsd_role_adapter class is what the multi_socket bsd_adapters share: hostname, which every role has, and
+     * every other operation refused with std::logic_error until the adapter of a role overrides it.
+     * A multi_socket only has the operations of its role, e.g. no accept_from on a tcp_client_socket. Called on the socket
+     * itself that fails to compile, but code holding a bsd_interface has given up the type that would tell, so it is told
+     * at run time instead.
+     */
+    template<typename socket_type>
+    class bsd_role_adapter : public bsd_interface {
+
+    public:
+
+        explicit bsd_role_adapter(socket_type& sckt) : _sckt(sckt) {}
+
+        void bind_to(address_t&, port_t) override { _refused("bind_to"); }
+
+        void listen_to() override { _refused("listen_to"); }
+
+        bool is_listening() const override { _refused("is_listening"); }
+
+        sockfd_t accept_from() override { _refused("accept_from"); }
+
+        void connect_to(address_t&, port_t) override { _refused("connect_to"); }
+
+        void be_non_blocking() override { _refused("be_non_blocking"); }
+
+        size_t peek() const override { _refused("peek"); }
+
+        std::string read(flag_t = 0) const override { _refused("read"); }
+
+        long write(address_t&, flag_t = 0) const override { _refused("write"); }
+
+        long read(char*, size_t, flag_t = 0) const override { _refused("read"); }
+
+        long write(const char*, size_t, flag_t = 0) const override { _refused("write"); }
+
+        std::string read_from(flag_t = 0) override { _refused("read_from"); }
+
+        long write_back(const std::string&, flag_t = 0) override { _refused("write_back"); }
+
+        long read_from(char*, size_t, flag_t = 0) override { _refused("read_from"); }
+
+        long write_back(const char*, size_t, flag_t = 0) override { _refused("write_back"); }
+
+        long write_v(const const_buffer*, size_t, flag_t = 0) const override { _refused("write_v"); }
+
+        long read_v(const mutable_buffer*, size_t, flag_t = 0) const override { _refused("read_v"); }
+
+        long write_back_v(const const_buffer*, size_t, flag_t = 0) override { _refused("write_back_v"); }
+
+        long read_from_v(const mutable_buffer*, size_t, flag_t = 0) override { _refused("read_from_v"); }
+
+        std::string hostname() const override {
+            return _sckt.hostname();
+        }
+
+        void reset() override { _refused("reset"); }
+
+        void stop(action_t) override { _refused("stop"); }
+
+        /**
+         * @brief wrapped - the socket itself, for the members bsd_interface does not have
+         */
+        socket_type& wrapped() const {
+            return _sckt;
+        }
+
+    protected:
+
+        [[noreturn]] static void _refused(const char* operation) {
+            throw std::logic_error(std::string(operation) + " is not an operation of this socket's role");
+        }
+
+        socket_type& _sckt;
+
+    };
+
+    /**
+     * @brief The bsd_connected_adapter class forwards the reads and writes of the connected roles, tcp_active_socket,
+     * tcp_client_socket and udp_client_socket
+     */
+    template<typename socket_type>
+    class bsd_connected_adapter : public bsd_role_adapter<socket_type> {
+
+    public:
+
+        using bsd_role_adapter<socket_type>::bsd_role_adapter;
+
+        std::string read(flag_t flags = 0) const override {
+            return this->_sckt.read(flags);
+        }
+
+        long write(address_t& buffer, flag_t flags = 0) const override {
+            return this->_sckt.write(buffer, flags);
+        }
+
+        long read(char* buffer, size_t length, flag_t flags = 0) const override {
+            return this->_sckt.read(buffer, length, flags);
+        }
+
+        long write(const char* buffer, size_t length, flag_t flags = 0) const override {
+            return this->_sckt.write(buffer, length, flags);
+        }
+
+        long write_v(const const_buffer* buffers, size_t count, flag_t flags = 0) const override {
+            return this->_sckt.write_v(buffers, count, flags);
+        }
+
+        long read_v(const mutable_buffer* buffers, size_t count, flag_t flags = 0) const override {
+            return this->_sckt.read_v(buffers, count, flags);
+        }
+
+    };
+
+    //------------tcp_active_socket adapter, tuned ones included------------
+    template<typename options_type>
+    class bsd_adapter<multi_socket<protocol_t::TCP, role_t::active, family_t::IPv4, socket_t::STREAM, options_type>> final :
+        public bsd_connected_adapter<multi_socket<protocol_t::TCP, role_t::active, family_t::IPv4, socket_t::STREAM, options_type>> {
+
+    public:
+
+        using bsd_connected_adapter<multi_socket<protocol_t::TCP, role_t::active, family_t::IPv4, socket_t::STREAM, options_type>>::bsd_connected_adapter;
+
+        size_t peek() const override {
+            return this->_sckt.peek();
+        }
+
+        void stop(action_t action) override {
+            this->_sckt.stop(action);
+        }
+
+    };
+
+    //------------tcp_client_socket adapter, tuned ones included------------
+    template<typename options_type>
+    class bsd_adapter<multi_socket<protocol_t::TCP, role_t::client, family_t::IPv4, socket_t::STREAM, options_type>> final :
+        public bsd_connected_adapter<multi_socket<protocol_t::TCP, role_t::client, family_t::IPv4, socket_t::STREAM, options_type>> {
+
+    public:
+
+        using bsd_connected_adapter<multi_socket<protocol_t::TCP, role_t::client, family_t::IPv4, socket_t::STREAM, options_type>>::bsd_connected_adapter;
+
+        void stop(action_t action) override {
+            this->_sckt.stop(action);
+        }
+
+    };
+
+    //------------tcp_server_socket adapter, tuned ones included------------
+    template<typename options_type>
+    class bsd_adapter<multi_socket<protocol_t::TCP, role_t::server, family_t::IPv4, socket_t::STREAM, options_type>> final :
+        public bsd_role_adapter<multi_socket<protocol_t::TCP, role_t::server, family_t::IPv4, socket_t::STREAM, options_type>> {
+
+    public:
+
+        using bsd_role_adapter<multi_socket<protocol_t::TCP, role_t::server, family_t::IPv4, socket_t::STREAM, options_type>>::bsd_role_adapter;
+
+        sockfd_t accept_from() override {
+            return this->_sckt.accept_from();
+        }
+
+        void stop(action_t action) override {
+            this->_sckt.stop(action);
+        }
+
+    };
+
+    //------------udp_client_socket adapter------------
+    template<>
+    class bsd_adapter<udp_client_socket> final : public bsd_connected_adapter<udp_client_socket> {
+
+    public:
+
+        using bsd_connected_adapter<udp_client_socket>::bsd_connected_adapter;
+
+    };
+
+    //------------udp_server_socket adapter------------
+    template<>
+    class bsd_adapter<udp_server_socket> final : public bsd_role_adapter<udp_server_socket> {
+
+    public:
+
+        using bsd_role_adapter<udp_server_socket>::bsd_role_adapter;
+
+        std::string read_from(flag_t flags = 0) override {
+            return _sckt.read_from(flags);
+        }
+
+        long write_back(const std::string& buffer, flag_t flags = 0) override {
+            return _sckt.write_back(buffer, flags);
+        }
+
+        long read_from(char* buffer, size_t length, flag_t flags = 0) override {
+            return _sckt.read_from(buffer, length, flags);
+        }
+
+        long write_back(const char* buffer, size_t length, flag_t flags = 0) override {
+            return _sckt.write_back(buffer, length, flags);
+        }
+
+        long write_back_v(const const_buffer* buffers, size_t count, flag_t flags = 0) override {
+            return _sckt.write_back_v(buffers, count, flags);
+        }
+
+        long read_from_v(const mutable_buffer* buffers, size_t count, flag_t flags = 0) override {
+            return _sckt.read_from_v(buffers, count, flags);
+        }
+
+    };
+
+}   /*! @} */
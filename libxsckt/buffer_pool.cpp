@@ -0,0 +1,208 @@
+#include "buffer_pool.h"
+
+#include <cassert>
+#include <new>
+#include <sstream>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    //------------pooled_buffer implementation------------
+    pooled_buffer::pooled_buffer(const pooled_buffer& other) :
+        _chunk(other._chunk)
+    {
+        if (_chunk) {
+            _chunk->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    pooled_buffer::pooled_buffer(pooled_buffer&& other) noexcept :
+        _chunk(other._chunk)
+    {
+        other._chunk = nullptr;
+    }
+
+    pooled_buffer& pooled_buffer::operator= (pooled_buffer other) noexcept {
+        std::swap(_chunk, other._chunk);
+        return *this;
+    }
+
+    pooled_buffer::~pooled_buffer() {
+        if (_chunk && _chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            buffer_pool::instance().release(_chunk);
+        }
+    }
+
+    void pooled_buffer::resize(const size_t size) {
+        assert(size <= capacity());
+        _chunk->size = size;
+    }
+
+    bool pooled_buffer::unique() const {
+        return _chunk->refs.load(std::memory_order_acquire) == 1;
+    }
+
+    //------------buffer_pool implementation------------
+    const std::array<size_t, buffer_pool::SIZE_CLASSES> buffer_pool::CHUNK_SIZES = { 4096, 16384, 65536 };
+
+    /**
+     * @brief thread_cache - the calling thread's free lists, handed back to the shared lists when the thread exits
+     */
+    struct buffer_pool::thread_cache {
+
+        std::array<buffer_chunk*, SIZE_CLASSES> free{};
+        std::array<size_t, SIZE_CLASSES> count{};
+
+        ~thread_cache() {
+            for (unsigned int c = 0; c < SIZE_CLASSES; ++c) {
+                if (free[c]) {
+                    auto last = free[c];
+                    while (last->next) {
+                        last = last->next;
+                    }
+                    buffer_pool::instance().give_back(c, free[c], last);
+                }
+            }
+        }
+
+    };
+
+    thread_local buffer_pool::thread_cache buffer_pool::_cache;
+
+    buffer_pool& buffer_pool::instance() {
+        static buffer_pool pool;
+        return pool;
+    }
+
+    buffer_pool::~buffer_pool() {
+        for (auto chunk : _free) {
+            while (chunk) {
+                auto next = chunk->next;
+                chunk->~buffer_chunk();
+                ::operator delete(chunk);
+                chunk = next;
+            }
+        }
+    }
+
+    pooled_buffer buffer_pool::acquire(const size_t size) {
+        unsigned int c = 0;
+        while (c < SIZE_CLASSES && CHUNK_SIZES[c] < size) {
+            ++c;
+        }
+        if (c == SIZE_CLASSES) {
+            //too big to keep, e.g. the reassembly buffer of one long message
+            auto chunk = new (::operator new(sizeof(buffer_chunk) + size)) buffer_chunk;
+            chunk->refs.store(1, std::memory_order_relaxed);
+            chunk->size_class = SIZE_CLASSES;
+            chunk->size = 0;
+            chunk->capacity = size;
+            chunk->next = nullptr;
+            _oversize.fetch_add(1, std::memory_order_relaxed);
+            return pooled_buffer(chunk);
+        }
+        auto chunk = _cache.free[c];
+        if (chunk) {
+            _cache.free[c] = chunk->next;
+            --_cache.count[c];
+        }
+        else {
+            chunk = refill(c);
+        }
+        chunk->refs.store(1, std::memory_order_relaxed);
+        chunk->size = 0;
+        chunk->next = nullptr;
+        auto in_use = _in_use[c].fetch_add(1, std::memory_order_relaxed) + 1;
+        auto high_water = _high_water[c].load(std::memory_order_relaxed);
+        while (in_use > high_water && !_high_water[c].compare_exchange_weak(high_water, in_use, std::memory_order_relaxed)) {}
+        return pooled_buffer(chunk);
+    }
+
+    buffer_pool::stats_t buffer_pool::stats() const {
+        stats_t s;
+        for (size_t c = 0; c < SIZE_CLASSES; ++c) {
+            s.chunk_size[c] = CHUNK_SIZES[c];
+            s.in_use[c] = _in_use[c].load(std::memory_order_relaxed);
+            s.high_water[c] = _high_water[c].load(std::memory_order_relaxed);
+            s.allocated[c] = _allocated[c].load(std::memory_order_relaxed);
+        }
+        s.oversize = _oversize.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    std::string buffer_pool::report() const {
+        auto s = stats();
+        std::stringstream ss;
+        for (size_t c = 0; c < SIZE_CLASSES; ++c) {
+            ss << "buffer_pool " << s.chunk_size[c] << "B in_use " << s.in_use[c]
+                << " high_water " << s.high_water[c] << " allocated " << s.allocated[c] << "\n";
+        }
+        ss << "buffer_pool oversize allocated " << s.oversize << "\n";
+        return ss.str();
+    }
+
+    void buffer_pool::release(buffer_chunk* chunk) {
+        auto c = chunk->size_class;
+        if (c == SIZE_CLASSES) {
+            chunk->~buffer_chunk();
+            ::operator delete(chunk);
+            return;
+        }
+        _in_use[c].fetch_sub(1, std::memory_order_relaxed);
+        chunk->next = _cache.free[c];
+        _cache.free[c] = chunk;
+        if (++_cache.count[c] > THREAD_CACHE_LIMIT) {
+            //hand the older half back so a thread that only frees, e.g. a consumer of another thread's reads, does not hoard
+            auto keep = THREAD_CACHE_LIMIT / 2;
+            auto last = _cache.free[c];
+            for (size_t i = 1; i < keep; ++i) {
+                last = last->next;
+            }
+            auto first = last->next;
+            last->next = nullptr;
+            last = first;
+            while (last->next) {
+                last = last->next;
+            }
+            give_back(c, first, last);
+            _cache.count[c] = keep;
+        }
+    }
+
+    buffer_chunk* buffer_pool::refill(unsigned int size_class) {
+        {
+            //take up to half a cache's worth from the shared list in one go
+            std::lock_guard<std::mutex> guard(_lock);
+            auto first = _free[size_class];
+            if (first) {
+                auto last = first;
+                size_t n = 1;
+                while (last->next && n < THREAD_CACHE_LIMIT / 2) {
+                    last = last->next;
+                    ++n;
+                }
+                _free[size_class] = last->next;
+                last->next = nullptr;
+                _cache.free[size_class] = first->next;
+                _cache.count[size_class] += n - 1;
+                return first;
+            }
+        }
+        auto memory = ::operator new(sizeof(buffer_chunk) + CHUNK_SIZES[size_class]);
+        auto chunk = new (memory) buffer_chunk;
+        chunk->size_class = size_class;
+        chunk->capacity = CHUNK_SIZES[size_class];
+        _allocated[size_class].fetch_add(1, std::memory_order_relaxed);
+        return chunk;
+    }
+
+    void buffer_pool::give_back(unsigned int size_class, buffer_chunk* first, buffer_chunk* last) {
+        std::lock_guard<std::mutex> guard(_lock);
+        last->next = _free[size_class];
+        _free[size_class] = first;
+    }
+
+}   /*! @} */
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+#include "xsckt.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief buffer_chunk - header of a pooled chunk, the payload follows it in the same allocation
+     */
+    struct buffer_chunk {
+        std::atomic<unsigned int> refs;
+        unsigned int size_class;    // SIZE_CLASSES for an oversize chunk
+        size_t size;
+        size_t capacity;
+        buffer_chunk* next;
+
+        char* data() {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    /**
+     * @brief The pooled_buffer class is a reference counted handle to a chunk of a buffer_pool.
+     * Copies share the chunk, which goes back to the pool when the last handle is destroyed, so a buffer filled by
+     * a socket read can be handed on to application code without copying the bytes.
+     */
+    class pooled_buffer {
+
+    public:
+
+        pooled_buffer() = default;
+
+        pooled_buffer(const pooled_buffer& other);
+
+        pooled_buffer(pooled_buffer&& other) noexcept;
+
+        pooled_buffer& operator= (pooled_buffer other) noexcept;
+
+        ~pooled_buffer();
+
+        /**
+         * @brief data - the start of the chunk
+         */
+        char* data() const {
+            return _chunk->data();
+        }
+
+        /**
+         * @brief size - the number of bytes in use
+         */
+        size_t size() const {
+            return _chunk->size;
+        }
+
+        /**
+         * @brief capacity - the size of the chunk
+         */
+        size_t capacity() const {
+            return _chunk->capacity;
+        }
+
+        /**
+         * @brief resize - set the number of bytes in use, at most capacity
+         */
+        void resize(const size_t size);
+
+        /**
+         * @brief unique - true if no other handle shares this chunk, so it may be refilled
+         */
+        bool unique() const;
+
+        explicit operator bool() const {
+            return _chunk != nullptr;
+        }
+
+    private:
+
+        friend class buffer_pool;
+
+        explicit pooled_buffer(buffer_chunk* chunk) : _chunk(chunk) {}
+
+        buffer_chunk* _chunk{ nullptr };
+
+    };
+
+    /**
+     * @brief The buffer_pool class is a process wide slab allocator of 4K, 16K and 64K receive buffers.
+     * @version 0.1
+     * Each thread keeps its own free lists so acquire and release take no lock; a thread only touches the shared
+     * lists, under a mutex, to trade chunks in batches when its own lists run dry or grow too long.
+     * Chunks are never returned to the heap, so stats().high_water is the number worth sizing the pool with. A request
+     * larger than the largest chunk is allocated on its own and freed when released, counted in stats().oversize.
+     */
+    class buffer_pool {
+
+    public:
+
+        static const size_t SIZE_CLASSES = 3;
+
+        static const size_t THREAD_CACHE_LIMIT = 64;    // chunks per size class a thread keeps before giving some back
+
+        static const std::array<size_t, SIZE_CLASSES> CHUNK_SIZES;
+
+        /**
+         * @brief stats_t - per size class chunk counts
+         */
+        struct stats_t {
+            std::array<size_t, SIZE_CLASSES> chunk_size;
+            std::array<size_t, SIZE_CLASSES> in_use;        // held by a pooled_buffer now
+            std::array<size_t, SIZE_CLASSES> high_water;    // most ever held at once
+            std::array<size_t, SIZE_CLASSES> allocated;     // taken from the heap
+            size_t oversize;                                // chunks too large for any class, allocated and freed one by one
+        };
+
+        /**
+         * @brief instance - the process wide pool
+         */
+        static buffer_pool& instance();
+
+        buffer_pool(const buffer_pool&) = delete;
+
+        buffer_pool& operator= (const buffer_pool&) = delete;
+
+        ~buffer_pool();
+
+        /**
+         * @brief acquire - a buffer from the smallest size class that holds size bytes
+         * @note a size larger than the largest chunk gets an oversize chunk of exactly size bytes from the heap
+         * @param size - bytes required
+         * @return pooled_buffer - capacity() at least size, size() 0
+         */
+        pooled_buffer acquire(const size_t size = LARGE_BUFFER_SIZE);
+
+        /**
+         * @brief stats - snapshot of the pool counters
+         */
+        stats_t stats() const;
+
+        /**
+         * @brief report - stats as text, one line per size class
+         */
+        std::string report() const;
+
+    private:
+
+        friend class pooled_buffer;
+
+        buffer_pool() = default;
+
+        void release(buffer_chunk* chunk);
+
+        buffer_chunk* refill(unsigned int size_class);
+
+        void give_back(unsigned int size_class, buffer_chunk* first, buffer_chunk* last);
+
+        mutable std::mutex _lock;
+        std::array<buffer_chunk*, SIZE_CLASSES> _free{};            // shared free lists, guarded by _lock
+        std::array<std::atomic<size_t>, SIZE_CLASSES> _in_use{};
+        std::array<std::atomic<size_t>, SIZE_CLASSES> _high_water{};
+        std::array<std::atomic<size_t>, SIZE_CLASSES> _allocated{};
+        std::atomic<size_t> _oversize{ 0 };
+
+        struct thread_cache;
+
+        static thread_local thread_cache _cache;
+
+    };
+
+    /**
+     * @brief read_pooled - read from a connected socket into a pooled buffer
+     * The buffer is refilled in place if no one else holds it, otherwise a fresh one is drawn from the pool.
+     * @param sckt - any multi_socket with read(char*, size_t, flags)
+     * @param buffer - set to the bytes read
+     * @param flags - as read
+     * @return long - as read
+     */
+    template<XSCKT_STREAM_SOCKET socket_type>
+    long read_pooled(const socket_type& sckt, pooled_buffer& buffer, const int flags = 0) {
+        if (!buffer || !buffer.unique()) {
+            buffer = buffer_pool::instance().acquire();
+        }
+        auto i = sckt.read(buffer.data(), buffer.capacity(), flags);
+        buffer.resize((i > 0) ? static_cast<size_t>(i) : 0);
+        return i;
+    }
+
+    /**
+     * @brief read_from_pooled - receive a datagram into a pooled buffer, remembering the sender for write_back
+     * @param sckt - any multi_socket with read_from(char*, size_t, flags)
+     * @param buffer - set to the bytes received
+     * @param flags - as read_from
+     * @return long - as read_from
+     */
+    template<XSCKT_DATAGRAM_SOCKET socket_type>
+    long read_from_pooled(socket_type& sckt, pooled_buffer& buffer, const int flags = 0) {
+        if (!buffer || !buffer.unique()) {
+            buffer = buffer_pool::instance().acquire();
+        }
+        auto i = sckt.read_from(buffer.data(), buffer.capacity(), flags);
+        buffer.resize((i > 0) ? static_cast<size_t>(i) : 0);
+        return i;
+    }
+
+}   /*! @} */
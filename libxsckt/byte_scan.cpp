@@ -0,0 +1,82 @@
+#include "byte_scan.h"
+
+#include <cstring>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+#ifdef XSCKT_X86
+
+    XSCKT_TARGET("sse2")
+    static const char* _find_byte_sse2(const char* data, size_t size, char byte) {
+        auto needle = _mm_set1_epi8(byte);
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16) {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+            if (mask) {
+                return data + i + _first_bit(mask);
+            }
+        }
+        return static_cast<const char*>(std::memchr(data + i, byte, size - i));
+    }
+
+    XSCKT_TARGET("avx2")
+    static const char* _find_byte_avx2(const char* data, size_t size, char byte) {
+        auto needle = _mm256_set1_epi8(byte);
+        size_t i = 0;
+        //two vectors a turn, tested together, so the loop branches once per 64 bytes
+        for (; i + 64 <= size; i += 64) {
+            auto a = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), needle);
+            auto b = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32)), needle);
+            if (!_mm256_testz_si256(_mm256_or_si256(a, b), _mm256_or_si256(a, b))) {
+                auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(a));
+                if (mask) {
+                    return data + i + _first_bit(mask);
+                }
+                return data + i + 32 + _first_bit(static_cast<unsigned int>(_mm256_movemask_epi8(b)));
+            }
+        }
+        for (; i + 32 <= size; i += 32) {
+            auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), needle)));
+            if (mask) {
+                return data + i + _first_bit(mask);
+            }
+        }
+        return _find_byte_sse2(data + i, size - i, byte);
+    }
+
+#endif // XSCKT_X86
+
+    static const char* _find_byte_scalar(const char* data, size_t size, char byte) {
+        return static_cast<const char*>(std::memchr(data, byte, size));
+    }
+
+    using find_byte_t = const char* (*)(const char*, size_t, char);
+
+    static find_byte_t _select_find_byte() {
+#ifdef XSCKT_X86
+        switch (simd_level()) {
+        case simd_t::AVX2:
+            return _find_byte_avx2;
+        case simd_t::SSE42:
+        case simd_t::SSE2:
+            return _find_byte_sse2;
+        default:
+            break;
+        }
+#endif
+        return _find_byte_scalar;
+    }
+
+    const char* find_byte(const char* data, size_t size, char byte) {
+        //resolved on first use rather than at static initialisation, so other static initialisers may scan too
+        static const find_byte_t find = _select_find_byte();
+        return find(data, size, byte);
+    }
+
+}   /*! @} */
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+#include "simd.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief find_byte - the first occurrence of byte in data, 16 or 32 bytes a compare on SSE2/AVX2 CPUs
+     * @return const char* - pointer to it, or nullptr if there is none
+     */
+    const char* find_byte(const char* data, size_t size, char byte);
+
+}   /*! @} */
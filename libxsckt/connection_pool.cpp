@@ -0,0 +1,135 @@
+#include "connection_pool.h"
+
+#include <stdexcept>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    connection_lease::connection_lease(connection_pool* pool, std::string key, std::unique_ptr<tcp_client_socket> sckt, bool reused) :
+        _pool(pool),
+        _key(std::move(key)),
+        _sckt(std::move(sckt)),
+        _reused(reused)
+    {
+    }
+
+    connection_lease::connection_lease(connection_lease&& other) noexcept :
+        _pool(other._pool),
+        _key(std::move(other._key)),
+        _sckt(std::move(other._sckt)),
+        _reused(other._reused)
+    {
+        other._pool = nullptr;
+    }
+
+    connection_lease& connection_lease::operator= (connection_lease&& other) noexcept {
+        if (this != &other) {
+            release();
+            _pool = other._pool;
+            _key = std::move(other._key);
+            _sckt = std::move(other._sckt);
+            _reused = other._reused;
+            other._pool = nullptr;
+        }
+        return *this;
+    }
+
+    connection_lease::~connection_lease() {
+        release();
+    }
+
+    void connection_lease::release() {
+        if (_pool && _sckt) {
+            _pool->_release(_key, std::move(_sckt));
+        }
+        _sckt.reset();
+        _pool = nullptr;
+    }
+
+    void connection_lease::discard() {
+        _sckt.reset();     // closes the socket
+        _pool = nullptr;
+    }
+
+    connection_pool::connection_pool(size_t max_idle, std::chrono::milliseconds connect_timeout) :
+        _max_idle(max_idle),
+        _connect_timeout(connect_timeout)
+    {
+    }
+
+    bool connection_pool::_is_clean(tcp_client_socket& sckt) {
+        //a pooled connection should have nothing to read: the end of the stream means the peer closed it, bytes mean a
+        //late reply the last user never read, either way it cannot be handed out again
+        try {
+#ifdef WIN32
+            //winsock has no MSG_DONTWAIT, poll without waiting instead
+            WSAPOLLFD p = { sckt.handle(), POLLRDNORM, 0 };
+            return WSAPoll(&p, 1, 0) == 0;
+#else
+            char byte;
+            return sckt.read(&byte, 1, MSG_PEEK | MSG_DONTWAIT) < 0 && would_block();
+#endif
+        }
+        catch (const std::exception&) {
+            return false;   // e.g. reset by the peer
+        }
+    }
+
+    connection_lease connection_pool::acquire(const std::string& addr, unsigned short port) {
+        auto key = addr + ":" + std::to_string(port);
+        while (true) {
+            std::unique_ptr<tcp_client_socket> sckt;
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                auto it = _idle.find(key);
+                if (it == _idle.end() || it->second.empty()) {
+                    break;
+                }
+                sckt = std::move(it->second.back());
+                it->second.pop_back();
+                --_stats.idle;
+            }
+            if (_is_clean(*sckt)) {
+                std::lock_guard<std::mutex> lock(_lock);
+                ++_stats.reuses;
+                return connection_lease(this, std::move(key), std::move(sckt), true);
+            }
+            std::lock_guard<std::mutex> lock(_lock);
+            ++_stats.stale;
+        }
+        auto sckt = std::make_unique<tcp_client_socket>(addr, port, blocking_t::BLOCKING, _connect_timeout);
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            ++_stats.connects;
+        }
+        return connection_lease(this, std::move(key), std::move(sckt), false);
+    }
+
+    void connection_pool::_release(const std::string& key, std::unique_ptr<tcp_client_socket> sckt) {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto& idle = _idle[key];
+        if (idle.size() < _max_idle) {
+            idle.push_back(std::move(sckt));
+            ++_stats.idle;
+        }
+        //otherwise closed when sckt is destroyed on return, after the lock is released
+    }
+
+    void connection_pool::clear() {
+        decltype(_idle) idle;   // closed on return, outside the lock
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            idle.swap(_idle);
+            _stats.idle = 0;
+        }
+    }
+
+    connection_pool::stats_t connection_pool::stats() const {
+        std::lock_guard<std::mutex> lock(_lock);
+        return _stats;
+    }
+
+}   /*! @} */
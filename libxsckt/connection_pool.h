@@ -0,0 +1,152 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "socket_factory.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    class connection_pool;
+
+    /**
+     * @brief The connection_lease class is the exclusive use of one pooled tcp_client_socket, returned to its pool when destroyed.
+     * A lease is moved rather than copied. If a request fails half way, or for any other reason the protocol state of the
+     * stream is unknown, call discard so the connection is closed rather than handed to the next caller.
+     * @note the pool must outlive its leases
+     */
+    class connection_lease {
+
+    public:
+
+        connection_lease() = default;
+
+        connection_lease(connection_lease&& other) noexcept;
+
+        connection_lease& operator= (connection_lease&& other) noexcept;
+
+        connection_lease(const connection_lease&) = delete;
+
+        connection_lease& operator= (const connection_lease&) = delete;
+
+        ~connection_lease();
+
+        tcp_client_socket& operator* () const {
+            return *_sckt;
+        }
+
+        tcp_client_socket* operator-> () const {
+            return _sckt.get();
+        }
+
+        explicit operator bool() const {
+            return _sckt != nullptr;
+        }
+
+        /**
+         * @brief reused - true if the connection came from the pool, false if it was connected for this lease
+         */
+        bool reused() const {
+            return _reused;
+        }
+
+        /**
+         * @brief release - hand the connection back to the pool now rather than when the lease is destroyed
+         */
+        void release();
+
+        /**
+         * @brief discard - close the connection instead of returning it to the pool
+         */
+        void discard();
+
+    private:
+
+        friend class connection_pool;
+
+        connection_lease(connection_pool* pool, std::string key, std::unique_ptr<tcp_client_socket> sckt, bool reused);
+
+        connection_pool* _pool{ nullptr };
+        std::string _key;
+        std::unique_ptr<tcp_client_socket> _sckt;
+        bool _reused{ false };
+
+    };
+
+    /**
+     * @brief The connection_pool class keeps connected tcp_client_sockets to each addr:port for reuse, saving the address
+     * lookup and TCP handshake of a fresh connection, and the TIME_WAIT it leaves behind when closed.
+     * @version 0.1
+     * acquire hands out the most recently released idle connection to the endpoint, the one least likely to have been timed
+     * out by the server, after a non-blocking peek: one the peer has closed, or with unread bytes waiting, is thrown away and
+     * the next tried. Only when none is left is a new connection made. Released connections beyond max_idle for their endpoint
+     * are closed.
+     * @note thread safe - the lock is held only to take or return a socket, never across the peek or a connect
+     */
+    class connection_pool {
+
+    public:
+
+        /**
+         * @brief stats_t - counters since construction
+         */
+        struct stats_t {
+            size_t connects;    // new connections made
+            size_t reuses;      // leases served from the pool
+            size_t stale;       // idle connections found closed or unclean and thrown away
+            size_t idle;        // connections waiting in the pool now
+        };
+
+        /**
+         * @brief connection_pool
+         * @param max_idle - most idle connections kept per addr:port
+         * @param connect_timeout - give up on a new connection after this long, NO_TIMEOUT waits as long as the kernel does
+         */
+        explicit connection_pool(size_t max_idle = DEFAULT_POOL_SIZE, std::chrono::milliseconds connect_timeout = NO_TIMEOUT);
+
+        connection_pool(const connection_pool&) = delete;
+
+        connection_pool& operator= (const connection_pool&) = delete;
+
+        /**
+         * @brief acquire - a live blocking connection to addr:port, reused if one is idle
+         * @note throws if a new connection is needed and cannot be made
+         */
+        connection_lease acquire(const std::string& addr, unsigned short port);
+
+        /**
+         * @brief clear - close every idle connection, e.g. after a backend restart
+         */
+        void clear();
+
+        /**
+         * @brief stats - snapshot of the pool counters
+         */
+        stats_t stats() const;
+
+    private:
+
+        friend class connection_lease;
+
+        static bool _is_clean(tcp_client_socket& sckt);
+
+        void _release(const std::string& key, std::unique_ptr<tcp_client_socket> sckt);
+
+        size_t _max_idle;
+        std::chrono::milliseconds _connect_timeout;
+
+        mutable std::mutex _lock;
+        std::unordered_map<std::string, std::vector<std::unique_ptr<tcp_client_socket>>> _idle;  // most recently released last
+        stats_t _stats{ 0, 0, 0, 0 };
+
+    };
+
+}   /*! @} */
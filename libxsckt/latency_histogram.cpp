@@ -0,0 +1,122 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /*
+     * Values below SUB_BUCKETS have a bucket each. Above that a value whose top bit is b goes in range e = b + 1 - SUB_BUCKET_BITS,
+     * at index e * SUB_BUCKETS / 2 + (value >> e), so each range doubles the width of its buckets and the indices run on
+     * without a gap.
+     */
+
+    static unsigned int _top_bit(unsigned long long value) {
+        unsigned int bit = 0;
+        for (unsigned int shift = 32; shift > 0; shift >>= 1) {
+            if (value >> shift) {
+                value >>= shift;
+                bit += shift;
+            }
+        }
+        return bit;
+    }
+
+    latency_histogram::latency_histogram(unsigned long long highest) {
+        if (highest < SUB_BUCKETS) {
+            highest = SUB_BUCKETS;
+        }
+        _counts.resize(_index(highest) + 1);
+    }
+
+    size_t latency_histogram::_index(unsigned long long value) const {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        auto range = _top_bit(value) + 1 - SUB_BUCKET_BITS;
+        return static_cast<size_t>(range) * (SUB_BUCKETS / 2) + static_cast<size_t>(value >> range);
+    }
+
+    unsigned long long latency_histogram::_highest(size_t index) const {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        auto range = static_cast<unsigned int>(index / (SUB_BUCKETS / 2) - 1);
+        auto sub = static_cast<unsigned long long>(index - range * (SUB_BUCKETS / 2));
+        return ((sub + 1) << range) - 1;
+    }
+
+    void latency_histogram::record(unsigned long long value, unsigned long long count) {
+        _counts[std::min(_index(value), _counts.size() - 1)] += count;
+        _count += count;
+        _sum += static_cast<double>(value) * static_cast<double>(count);
+        _min = std::min(_min, value);
+        _max = std::max(_max, value);
+    }
+
+    void latency_histogram::merge(const latency_histogram& other) {
+        if (other._counts.size() != _counts.size()) {
+            throw std::runtime_error("latency_histogram: merge of histograms with a different highest");
+        }
+        for (size_t i = 0; i < _counts.size(); ++i) {
+            _counts[i] += other._counts[i];
+        }
+        _count += other._count;
+        _sum += other._sum;
+        _min = std::min(_min, other._min);
+        _max = std::max(_max, other._max);
+    }
+
+    void latency_histogram::reset() {
+        std::fill(_counts.begin(), _counts.end(), 0);
+        _count = 0;
+        _sum = 0;
+        _min = ~0ULL;
+        _max = 0;
+    }
+
+    unsigned long long latency_histogram::min() const {
+        return _count ? _min : 0;
+    }
+
+    double latency_histogram::mean() const {
+        return _count ? _sum / static_cast<double>(_count) : 0.0;
+    }
+
+    unsigned long long latency_histogram::percentile(double percent) const {
+        if (_count == 0) {
+            return 0;
+        }
+        //the rank of the value wanted, rounded up so p100 is the last value and p0 the first
+        auto wanted = static_cast<unsigned long long>(std::clamp(percent, 0.0, 100.0) / 100.0 * static_cast<double>(_count) + 0.5);
+        wanted = std::max(wanted, 1ULL);
+        unsigned long long seen = 0;
+        for (size_t i = 0; i < _counts.size(); ++i) {
+            seen += _counts[i];
+            if (seen >= wanted) {
+                return std::min(_highest(i), _max);
+            }
+        }
+        return _max;
+    }
+
+    std::string latency_histogram::report(double scale, const char* unit) const {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1);
+        ss << "count " << _count << " mean " << mean() / scale << unit;
+        const char* names[] = { "p50", "p90", "p99", "p99.9", "p99.99" };
+        const double percents[] = { 50.0, 90.0, 99.0, 99.9, 99.99 };
+        for (size_t i = 0; i < 5; ++i) {
+            ss << " " << names[i] << " " << static_cast<double>(percentile(percents[i])) / scale << unit;
+        }
+        ss << " max " << static_cast<double>(_max) / scale << unit;
+        return ss.str();
+    }
+
+}   /*! @} */
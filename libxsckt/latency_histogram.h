@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief The latency_histogram class counts values, e.g. nanosecond latencies, in HDR style log linear buckets.
+     * @version 0.1
+     * Each power of two range is split into SUB_BUCKETS / 2 equal buckets, so any value is reported to within 1/128 of
+     * itself, from 1 up to highest, with a fixed few KB of counters and a shift and an add per record. Per thread
+     * histograms can be merged for the report.
+     * @note not thread safe - one latency_histogram per recording thread
+     */
+    class latency_histogram {
+
+    public:
+
+        static const unsigned int SUB_BUCKET_BITS = 8;
+        static const unsigned int SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+
+        /**
+         * @brief latency_histogram
+         * @param highest - largest value told apart, larger ones are counted in the top bucket; max() is still exact
+         */
+        explicit latency_histogram(unsigned long long highest = 3600000000000ULL);
+
+        void record(unsigned long long value, unsigned long long count = 1);
+
+        /**
+         * @brief merge - add in the counts of other, which must have the same highest
+         */
+        void merge(const latency_histogram& other);
+
+        void reset();
+
+        unsigned long long count() const {
+            return _count;
+        }
+
+        unsigned long long min() const;
+
+        unsigned long long max() const {
+            return _max;
+        }
+
+        double mean() const;
+
+        /**
+         * @brief percentile - the value percent (0 to 100) of the recorded values are at or below
+         * @return unsigned long long - the top of its bucket, at most max(); 0 if nothing was recorded
+         */
+        unsigned long long percentile(double percent) const;
+
+        /**
+         * @brief report - count, mean, p50, p90, p99, p99.9, p99.99 and max, each value divided by scale, e.g. 1000 for ns to us
+         */
+        std::string report(double scale = 1.0, const char* unit = "") const;
+
+    private:
+
+        size_t _index(unsigned long long value) const;
+
+        unsigned long long _highest(size_t index) const;
+
+        std::vector<unsigned long long> _counts;
+        unsigned long long _count{ 0 };
+        unsigned long long _min{ ~0ULL };
+        unsigned long long _max{ 0 };
+        double _sum{ 0 };
+
+    };
+
+}   /*! @} */
@@ -0,0 +1,107 @@
+#if defined(__linux__) && defined(__cpp_impl_coroutine)
+
+#include "linux_async.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    async_loop::async_loop(const size_t max_events) :
+        _loop(max_events)
+    {
+    }
+
+    async_loop::~async_loop() {
+        //a coroutine waits on one operation at a time so is parked in at most one slot
+        for (auto& p : _parked) {
+            for (auto w : { p.second.reader, p.second.writer }) {
+                if (w) {
+                    w->continuation.destroy();
+                }
+            }
+        }
+    }
+
+    void async_loop::spawn(task t) {
+        auto handle = t._handle;
+        t._handle = nullptr;
+        handle.resume();
+    }
+
+    void async_loop::run() {
+        _loop.run();
+    }
+
+    void async_loop::stop() {
+        _loop.stop();
+    }
+
+    void async_loop::forget(sockfd_t socket) {
+        auto it = _parked.find(socket);
+        if (it == _parked.end()) {
+            return;
+        }
+        for (auto w : { it->second.reader, it->second.writer }) {
+            if (w) {
+                _loop.timers().cancel(w->deadline);
+            }
+        }
+        _parked.erase(it);
+        _loop.unwatch(socket);
+    }
+
+    void async_loop::_park(sockfd_t socket, bool for_write, waiter_t* waiter) {
+        auto it = _parked.find(socket);
+        if (it == _parked.end()) {
+            //watched from the first wait until forget, edge triggering means an idle socket costs nothing
+            it = _parked.emplace(socket, parked_t()).first;
+            _loop.watch(socket, {
+                [this](sockfd_t s) { _ready(s, true, false); },
+                [this](sockfd_t s) { _ready(s, false, true); },
+                [this](sockfd_t s) { _ready(s, true, true); }
+                });
+        }
+        (for_write ? it->second.writer : it->second.reader) = waiter;
+    }
+
+    void async_loop::_ready(sockfd_t socket, bool readable, bool writable) {
+        for (auto for_write : { false, true }) {
+            if (!(for_write ? writable : readable)) {
+                continue;
+            }
+            //look the socket up again each time, the previous resume may have forgotten it
+            auto it = _parked.find(socket);
+            if (it == _parked.end()) {
+                return;
+            }
+            auto& slot = for_write ? it->second.writer : it->second.reader;
+            auto waiter = slot;
+            if (waiter && waiter->attempt()) {
+                slot = nullptr;
+                _loop.timers().cancel(waiter->deadline);
+                waiter->continuation.resume();
+            }
+        }
+    }
+
+    timer_handle async_loop::_arm(sockfd_t socket, bool for_write, waiter_t* waiter, std::chrono::milliseconds timeout) {
+        return _loop.timers().arm(timeout, [this, socket, for_write, waiter] {
+            //only if the waiter is still parked, it may have been forgotten along with its socket
+            auto it = _parked.find(socket);
+            if (it == _parked.end()) {
+                return;
+            }
+            auto& slot = for_write ? it->second.writer : it->second.reader;
+            if (slot == waiter) {
+                slot = nullptr;
+                waiter->time_out();
+                waiter->continuation.resume();
+            }
+        });
+    }
+
+}   /*! @} */
+
+#endif
@@ -0,0 +1,272 @@
+#pragma once
+
+#if defined(__linux__) && defined(__cpp_impl_coroutine)
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "linux_event_loop.h"
+#include "socket_factory.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief The task class is a detached coroutine handed to async_loop::spawn, e.g. one per connection.
+     * It starts when spawned, runs on the loop's thread until its first co_await that has to wait and frees itself when it returns.
+     * @note an exception escaping the coroutine ends the program, catch inside it
+     */
+    class task {
+
+    public:
+
+        struct promise_type {
+            task get_return_object() {
+                return task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+
+        task(task&& other) noexcept : _handle(other._handle) {
+            other._handle = nullptr;
+        }
+
+        task(const task&) = delete;
+
+        task& operator= (const task&) = delete;
+
+        ~task() {
+            if (_handle) {
+                _handle.destroy();  //never spawned
+            }
+        }
+
+    private:
+
+        friend class async_loop;
+
+        explicit task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+        std::coroutine_handle<promise_type> _handle;
+
+    };
+
+    /**
+     * @brief The async_loop class resumes coroutines as the sockets they co_await become ready, on top of an edge-triggered event_loop.
+     * @version 0.1
+     * accept, connect, read and write each try the operation straight away and only suspend the coroutine if it would block.
+     * The socket is then watched, and when it is next readable or writable the operation is tried again before the coroutine
+     * is resumed, so a coroutine always wakes up with a result rather than to another would block.
+     * connect, read and write take an optional timeout: if the operation is still parked when it expires the coroutine is
+     * resumed with a std::runtime_error instead. Deadlines are timers on the event loop's timer_wheel, armed only when the
+     * operation actually has to wait.
+     * @note sockets must be non-blocking, and forget must be called before a socket that has been awaited on is closed
+     * @note not thread safe - one async_loop per thread
+     */
+    class async_loop {
+
+        /**
+         * @brief waiter_t - an operation parked until its socket is ready
+         */
+        struct waiter_t {
+            virtual bool attempt() = 0;     // true once done, with a result or an error
+            virtual void time_out() = 0;    // the deadline passed first, fail with an error
+            std::coroutine_handle<> continuation;
+            timer_handle deadline;
+        protected:
+            ~waiter_t() = default;
+        };
+
+        /**
+         * @brief operation - awaitable that retries attempt_type until it stops reporting would block
+         * attempt_type is called as bool(result_type&) and may throw, the exception is rethrown from co_await
+         */
+        template<typename result_type, typename attempt_type>
+        class operation : private waiter_t {
+
+        public:
+
+            operation(async_loop& loop, sockfd_t socket, bool for_write, std::chrono::milliseconds timeout, attempt_type attempt) :
+                _loop(loop), _socket(socket), _for_write(for_write), _timeout(timeout), _attempt(std::move(attempt)) {}
+
+            bool await_ready() {
+                return attempt();
+            }
+
+            void await_suspend(std::coroutine_handle<> continuation) {
+                this->continuation = continuation;
+                _loop._park(_socket, _for_write, this);
+                if (_timeout > NO_TIMEOUT) {
+                    this->deadline = _loop._arm(_socket, _for_write, this, _timeout);
+                }
+            }
+
+            result_type await_resume() {
+                if (_error) {
+                    std::rethrow_exception(_error);
+                }
+                return _result;
+            }
+
+        private:
+
+            bool attempt() override {
+                try {
+                    return _attempt(_result);
+                }
+                catch (...) {
+                    _error = std::current_exception();
+                    return true;
+                }
+            }
+
+            void time_out() override {
+                _error = std::make_exception_ptr(std::runtime_error("timed out"));
+            }
+
+            async_loop& _loop;
+            sockfd_t _socket;
+            bool _for_write;
+            std::chrono::milliseconds _timeout;
+            attempt_type _attempt;
+            result_type _result{};
+            std::exception_ptr _error;
+
+        };
+
+        template<typename result_type, typename attempt_type>
+        operation<result_type, attempt_type> _operation(sockfd_t socket, bool for_write, std::chrono::milliseconds timeout, attempt_type attempt) {
+            return operation<result_type, attempt_type>(*this, socket, for_write, timeout, std::move(attempt));
+        }
+
+    public:
+
+        /**
+         * @brief async_loop - creates the event loop
+         * @param max_events - most ready sockets dispatched per epoll_wait system call
+         */
+        explicit async_loop(const size_t max_events = DEFAULT_MAX_EVENTS);
+
+        async_loop(const async_loop&) = delete;
+
+        async_loop& operator= (const async_loop&) = delete;
+
+        /**
+         * @brief ~async_loop - destroys the coroutines still waiting on a socket
+         */
+        ~async_loop();
+
+        /**
+         * @brief spawn - run a coroutine until it first has to wait, the loop resumes it from then on
+         */
+        void spawn(task t);
+
+        /**
+         * @brief run - resume coroutines until stop is called
+         */
+        void run();
+
+        /**
+         * @brief stop - make run return after the current batch of events
+         */
+        void stop();
+
+        /**
+         * @brief forget - stop watching a socket, call before closing it
+         */
+        void forget(sockfd_t socket);
+
+        /**
+         * @brief accept - co_await the next connection on a non-blocking listening socket
+         * @return sockfd_t - the SOCK_NONBLOCK | SOCK_CLOEXEC socket of the new connection
+         */
+        auto accept(tcp_server_socket& sckt) {
+            return _operation<sockfd_t>(sckt.handle(), false, NO_TIMEOUT, [&sckt](sockfd_t& result) {
+                result = sckt.accept_from();
+                return result != INVALID_SOCKET;
+            });
+        }
+
+        /**
+         * @brief connect - co_await the connection of a tcp_client_socket constructed NONBLOCKING, throws if it failed
+         * @param timeout - throw if it has not connected by then, NO_TIMEOUT waits as long as the kernel does
+         */
+        auto connect(tcp_client_socket& sckt, std::chrono::milliseconds timeout = NO_TIMEOUT) {
+            auto socket = sckt.handle();
+            return _operation<bool>(socket, true, timeout, [socket](bool& result) {
+                int error = 0;
+                socklen_t len = sizeof(error);
+                if (getsockopt(socket, SOL_SOCKET, SO_ERROR, &error, &len) == SOCKET_ERROR || error != 0) {
+                    errno = error ? error : errno;
+                    throw std::runtime_error(make_error_message());
+                }
+                struct sockaddr_in peer;
+                socklen_t len_peer = sizeof(peer);
+                //a connect still in progress has no peer yet
+                result = getpeername(socket, reinterpret_cast<struct sockaddr*>(&peer), &len_peer) == 0;
+                return result;
+            });
+        }
+
+        /**
+         * @brief read - co_await some bytes from any connected multi_socket with handle() and read(char*, size_t, flags)
+         * @param timeout - throw if nothing has arrived by then, e.g. to drop idle clients
+         * @return long - the number of bytes read, 0 on orderly shutdown by the peer
+         */
+        template<XSCKT_STREAM_SOCKET socket_type>
+        auto read(socket_type& sckt, char* buffer, size_t length, const int flags = 0, std::chrono::milliseconds timeout = NO_TIMEOUT) {
+            return _operation<long>(sckt.handle(), false, timeout, [&sckt, buffer, length, flags](long& result) {
+                result = sckt.read(buffer, length, flags);
+                return result >= 0;
+            });
+        }
+
+        /**
+         * @brief write - co_await the whole buffer being written to any connected multi_socket with handle() and write(const char*, size_t, flags)
+         * @param timeout - throw if the peer has not taken it all by then, counted from the first write that would block
+         * @return long - length, once it has all been written
+         */
+        template<XSCKT_STREAM_SOCKET socket_type>
+        auto write(socket_type& sckt, const char* buffer, size_t length, const int flags = 0, std::chrono::milliseconds timeout = NO_TIMEOUT) {
+            return _operation<long>(sckt.handle(), true, timeout, [&sckt, buffer, length, flags](long& result) {
+                while (static_cast<size_t>(result) < length) {
+                    auto i = sckt.write(buffer + result, length - static_cast<size_t>(result), flags);
+                    if (i < 0) {
+                        return false;
+                    }
+                    result += i;
+                }
+                return true;
+            });
+        }
+
+    private:
+
+        struct parked_t {
+            waiter_t* reader{ nullptr };
+            waiter_t* writer{ nullptr };
+        };
+
+        void _park(sockfd_t socket, bool for_write, waiter_t* waiter);
+
+        void _ready(sockfd_t socket, bool readable, bool writable);
+
+        timer_handle _arm(sockfd_t socket, bool for_write, waiter_t* waiter, std::chrono::milliseconds timeout);
+
+        event_loop _loop;
+        std::unordered_map<sockfd_t, parked_t> _parked;
+
+    };
+
+}   /*! @} */
+
+#endif
@@ -0,0 +1,112 @@
+#ifdef __linux__
+
+#include "linux_event_loop.h"
+
+#include <cassert>
+#include <stdexcept>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    event_loop::event_loop(const size_t max_events) :
+        _events(max_events)
+    {
+        assert(max_events > 0);
+        _epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (_epoll == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    event_loop::~event_loop() {
+        close(_epoll);
+    }
+
+    void event_loop::watch(sockfd_t socket, handlers_t handlers) {
+        auto w = std::make_unique<watch_t>(watch_t{ socket, std::move(handlers) });
+        struct epoll_event ev;
+        //register for everything once - edge triggering means an idle socket costs nothing
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = w.get();
+        if (epoll_ctl(_epoll, EPOLL_CTL_ADD, socket, &ev) == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+        _watched[socket] = std::move(w);
+    }
+
+    void event_loop::unwatch(sockfd_t socket) {
+        auto it = _watched.find(socket);
+        if (it == _watched.end()) {
+            return;
+        }
+        epoll_ctl(_epoll, EPOLL_CTL_DEL, socket, nullptr);
+        //events for this socket may still be pending in the current batch, so keep the watch alive but mark it dead
+        it->second->socket = INVALID_SOCKET;
+        _retired.push_back(std::move(it->second));
+        _watched.erase(it);
+    }
+
+    bool event_loop::_has_error(sockfd_t socket) {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        return getsockopt(socket, SOL_SOCKET, SO_ERROR, &error, &len) == SOCKET_ERROR || error != 0;
+    }
+
+    size_t event_loop::poll(const int timeout) {
+        auto due = _timers.next_timeout();
+        auto wait = (due == -1 || (timeout != -1 && timeout < due)) ? timeout : due;
+        auto n = epoll_wait(_epoll, _events.data(), static_cast<int>(_events.size()), wait);
+        if (n == SOCKET_ERROR) {
+            if (errno == EINTR) {
+                return 0;
+            }
+            throw std::runtime_error(make_error_message());
+        }
+        for (int i = 0; i < n; ++i) {
+            auto w = static_cast<watch_t*>(_events[i].data.ptr);
+            auto events = _events[i].events;
+            if ((events & EPOLLERR) && !(events & EPOLLHUP) && !_has_error(w->socket)) {
+                events &= ~EPOLLERR;    //only zero copy completions waiting on the error queue, the socket is fine
+            }
+            //a hang up is reported as readable first so any data still queued ahead of it is not lost
+            if (w->socket != INVALID_SOCKET && (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && w->handlers.on_readable) {
+                w->handlers.on_readable(w->socket);
+            }
+            if (w->socket != INVALID_SOCKET && (events & EPOLLOUT) && w->handlers.on_writable) {
+                w->handlers.on_writable(w->socket);
+            }
+            if (w->socket != INVALID_SOCKET && (events & (EPOLLHUP | EPOLLERR)) && w->handlers.on_closed) {
+                w->handlers.on_closed(w->socket);
+            }
+        }
+        //after the events, so a timeout racing the data it was waiting for loses
+        _timers.expire();
+        _retired.clear();
+        return static_cast<size_t>(n);
+    }
+
+    void event_loop::run() {
+        _running = true;
+        while (_running) {
+            poll();
+        }
+    }
+
+    void event_loop::stop() {
+        _running = false;
+    }
+
+    size_t event_loop::size() const {
+        return _watched.size();
+    }
+
+    timer_wheel& event_loop::timers() {
+        return _timers;
+    }
+
+}   /*! @} */
+
+#endif
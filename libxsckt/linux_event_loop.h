@@ -0,0 +1,120 @@
+#pragma once
+
+#ifdef __linux__
+
+#include <sys/epoll.h>
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "xsckt.h"
+#include "timer_wheel.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief The event_loop class is an edge-triggered epoll reactor that multiplexes any number of sockets on the calling thread.
+     * @version 0.1
+     * Each watched socket gets readable/writable/closed callbacks. Being edge-triggered a callback is only raised when the
+     * state of the socket changes, so on_readable must read until would_block() and on_writable must write until it either
+     * runs out of data or would_block().
+     * It also owns a timer_wheel for idle timeouts and deadlines; poll sleeps no longer than the next timer is due and
+     * fires expired timers after each batch of events.
+     * @note not thread safe - one event_loop per thread
+     */
+    class event_loop {
+
+    public:
+
+        using callback_t = std::function<void(sockfd_t)>;
+
+        /**
+         * @brief handlers_t - the callbacks for one watched socket, any of which may be left empty
+         */
+        struct handlers_t {
+            callback_t on_readable;     // data, or the end of the stream, is waiting to be read
+            callback_t on_writable;     // the send buffer has room again
+            callback_t on_closed;       // the peer hung up or the socket is in error
+        };
+
+        /**
+         * @brief event_loop - creates the epoll instance
+         * @param max_events - most ready sockets dispatched per epoll_wait system call
+         */
+        explicit event_loop(const size_t max_events = DEFAULT_MAX_EVENTS);
+
+        event_loop(const event_loop&) = delete;
+
+        event_loop& operator= (const event_loop&) = delete;
+
+        ~event_loop();
+
+        /**
+         * @brief watch - start raising events for a (non-blocking) socket
+         * @param socket - socket file descriptor
+         * @param handlers - callbacks to raise
+         */
+        void watch(sockfd_t socket, handlers_t handlers);
+
+        /**
+         * @brief unwatch - stop raising events for a socket, safe to call from inside any callback
+         * @note must be called before the socket is closed
+         * @param socket - socket file descriptor
+         */
+        void unwatch(sockfd_t socket);
+
+        /**
+         * @brief poll - wait for and dispatch one batch of events, then fire any timers that are due
+         * @param timeout - milliseconds to wait, -1 waits indefinitely, either way cut short by the next timer
+         * @return size_t - number of events dispatched
+         */
+        size_t poll(const int timeout = -1);
+
+        /**
+         * @brief run - dispatch events until stop is called
+         */
+        void run();
+
+        /**
+         * @brief stop - make run return after the current batch of events
+         */
+        void stop();
+
+        /**
+         * @brief size - number of sockets being watched
+         */
+        size_t size() const;
+
+        /**
+         * @brief timers - the wheel poll fires, timer callbacks may watch and unwatch sockets
+         */
+        timer_wheel& timers();
+
+    private:
+
+        struct watch_t {
+            sockfd_t socket;
+            handlers_t handlers;
+        };
+
+        static bool _has_error(sockfd_t socket);
+
+        int _epoll;
+        bool _running{ false };
+        timer_wheel _timers;
+
+        std::vector<struct epoll_event> _events;
+        std::unordered_map<sockfd_t, std::unique_ptr<watch_t>> _watched;
+        std::vector<std::unique_ptr<watch_t>> _retired;    // unwatched during a dispatch, freed once the batch is done
+
+    };
+
+}   /*! @} */
+
+#endif
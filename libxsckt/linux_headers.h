@@ -0,0 +1,74 @@
+#pragma once
+
+#ifdef __linux__
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netinet/udp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <poll.h>
+#include <linux/errqueue.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <climits>
+
+#include <string>
+#include <stdexcept>
+
+#include "socket_constants.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    using address_t = const std::string;
+    using sockfd_t = int;
+    using port_t = const unsigned short;
+    using flag_t = const int;
+
+    static const sockfd_t INVALID_SOCKET = -1;
+    static const int SOCKET_ERROR = -1;
+
+    static inline std::string make_error_message() {
+        char msgbuf[256];   // for a message up to 255 bytes.
+        msgbuf[0] = '\0';
+        // GNU strerror_r may return a pointer to a static string rather than fill msgbuf
+        const char* msg = strerror_r(errno, msgbuf, sizeof(msgbuf));
+        return (!msg || !*msg) ? std::string("undefined error") : std::string(msg);
+    }
+
+    /**
+     * @brief would_block - true if the last socket call on this thread failed only because a non-blocking socket was not ready
+     * @note errno is thread local so this is safe to call from any worker thread
+     */
+    static inline bool would_block() {
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+
+    //Linux specific...
+
+    /**
+     * @brief startup - no initialization is required by the Linux sockets API
+     * @return string - kernel sockets description
+     */
+    static inline std::string startup() {
+        return std::string("description: Linux BSD sockets");
+    }
+
+    /**
+     * @brief cleanup - no closedown is required by the Linux sockets API
+     */
+    static inline void cleanup() {}
+
+}   /*! @} */
+
+#endif
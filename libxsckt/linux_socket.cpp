@@ -0,0 +1,690 @@
+#ifdef __linux__
+
+#include "linux_socket.h"
+#include "metrics.h"
+
+#include <cassert>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string.h>
+#include <array>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    using io_vectors_t = std::array<struct iovec, MAX_IO_VECTORS>;
+
+    /**
+     * @brief _gather - copy up to MAX_IO_VECTORS buffer views into the iovec array sendmsg/recvmsg take
+     * @return size_t - number of iovecs filled
+     */
+    template<typename buffer_type>
+    static size_t _gather(const buffer_type* buffers, size_t count, io_vectors_t& iov) {
+        auto n = (count < iov.size()) ? count : iov.size();
+        for (size_t i = 0; i < n; ++i) {
+            iov[i].iov_base = const_cast<char*>(buffers[i].data);
+            iov[i].iov_len = buffers[i].size;
+        }
+        return n;
+    }
+
+    /**
+     * @brief _meter - count a read or write syscall that returned i, before anything else can change errno
+     */
+    static void _meter(direction_t direction, long i) {
+#ifndef XSCKT_NO_METRICS
+        metrics::io(direction, i, i == SOCKET_ERROR && would_block());
+#endif
+    }
+
+    /**
+     * @brief _meter_call - count any other syscall that returned i
+     */
+    static void _meter_call(long i) {
+#ifndef XSCKT_NO_METRICS
+        metrics::call(i, i == SOCKET_ERROR && would_block());
+#endif
+    }
+
+    base_socket::base_socket(const sockfd_t socket, blocking_t sync) :
+        _socket(socket),
+        _hints{},
+        _raddr{}
+    {
+        assert(_socket > 0);
+        //SO_REUSEADDR only matters to sockets that bind so an accepted socket is left alone
+        if (sync == blocking_t::BLOCKING) {
+            //accept_from hands out SOCK_NONBLOCK sockets so undo that
+            int mode = 0;
+            if (ioctl(_socket, FIONBIO, &mode) == SOCKET_ERROR) {
+                throw std::runtime_error(make_error_message());
+            }
+        }
+    }
+
+    base_socket::base_socket(const short address_family, const int socket_type, const int protocol, blocking_t sync) :
+        _address_family(address_family),
+        _socket_type(socket_type),
+        _protocol(protocol)
+    {
+        memset(&_hints, 0, sizeof(struct addrinfo));
+        memset(&_raddr, 0, sizeof(struct sockaddr_in));
+        _hints.ai_family = address_family;
+        _hints.ai_socktype = socket_type;
+        _hints.ai_flags = 0;
+        _hints.ai_protocol = protocol;
+
+        auto type = _socket_type | SOCK_CLOEXEC;
+        if (sync == blocking_t::NONBLOCKING) {
+            type |= SOCK_NONBLOCK;  // one system call instead of socket + be_non_blocking
+        }
+        _socket = socket(_address_family, type, _protocol);
+        if (_socket == INVALID_SOCKET) {
+            throw std::runtime_error(make_error_message());
+        }
+        int optval = 1;
+        if (setsockopt(_socket,
+            SOL_SOCKET,     // option at the socket level
+            SO_REUSEADDR,   // reuse the address
+            &optval,
+            sizeof(int)) == SOCKET_ERROR) {
+                throw std::runtime_error(make_error_message());
+        }
+        assert(_socket > 0);
+    }
+
+    base_socket::base_socket(base_socket&& other) noexcept :
+        _socket(other._socket),
+        _address_family(other._address_family),
+        _socket_type(other._socket_type),
+        _protocol(other._protocol),
+        _long_addr(other._long_addr),
+        _hints(other._hints),
+        _raddr(other._raddr),
+        _zero_copy_threshold(other._zero_copy_threshold),
+        _zero_copy_sent(other._zero_copy_sent),
+        _zero_copy_completed(other._zero_copy_completed)
+    {
+        other._socket = INVALID_SOCKET;
+        other._long_addr = nullptr;
+    }
+
+    base_socket& base_socket::operator= (base_socket&& other) noexcept {
+        if (this != &other) {
+            if (_socket != INVALID_SOCKET) {
+                close(_socket);
+            }
+            _socket = other._socket;
+            _address_family = other._address_family;
+            _socket_type = other._socket_type;
+            _protocol = other._protocol;
+            _long_addr = other._long_addr;
+            _hints = other._hints;
+            _raddr = other._raddr;
+            _zero_copy_threshold = other._zero_copy_threshold;
+            _zero_copy_sent = other._zero_copy_sent;
+            _zero_copy_completed = other._zero_copy_completed;
+            other._socket = INVALID_SOCKET;
+            other._long_addr = nullptr;
+        }
+        return *this;
+    }
+
+    base_socket::~base_socket() {
+        //the last close sends the FIN so there is no need to pay for a shutdown call as well
+        if (_socket != INVALID_SOCKET) {    // moved from
+            close(_socket);
+        }
+    }
+
+    void base_socket::bind_to(address_t& address, port_t port) {
+        auto e = _getaddrinfo(address, port);
+        if (e != 0) {
+            throw std::runtime_error(gai_strerror(e));
+        }
+        auto i = bind(_socket, _long_addr->ai_addr, _long_addr->ai_addrlen);
+        freeaddrinfo(_long_addr);
+        _long_addr = nullptr;
+        if (i == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    void base_socket::listen_to() {
+        //marks the socket referred to by _socket as a passive socket, that is,
+        //as a socket that will be used to accept incoming connection requests using accept
+        if (listen(_socket, MAX_BACKLOG) < 0) {
+            //MAX_BACKLOG defines the maximum length to which the queue of pending connections for _socket may grow
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    void base_socket::listen_to(int backlog) {
+        if (listen(_socket, backlog) < 0) {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    bool base_socket::is_listening() const {
+        int val;
+        socklen_t len = sizeof(val);
+        if (getsockopt(_socket,
+            SOL_SOCKET, //get options at the sockets API level
+            SO_ACCEPTCONN, //can it accepts connections i.e. passive listening
+            &val, &len) == SOCKET_ERROR)
+        {
+            throw std::runtime_error(make_error_message());
+        }
+        return val;
+    }
+
+    sockfd_t base_socket::accept_from() {
+        assert(is_listening());
+        socklen_t len_raddr = sizeof(_raddr);
+        auto s = accept4(_socket, //this bound and listening socket's file descriptor
+            reinterpret_cast<struct sockaddr*>(&_raddr), //filled in with the remote address of this peer socket
+            &len_raddr,
+            SOCK_NONBLOCK | SOCK_CLOEXEC); //saves the fcntl calls per accepted connection
+        _meter_call(s);
+        if (s != INVALID_SOCKET) {
+            metrics::count(counter_t::ACCEPTS);
+        }
+        if (s == INVALID_SOCKET && !would_block()) {
+            throw std::runtime_error(make_error_message());
+        }
+        return s; //the newly created socket using the connected file descriptor
+    }
+
+    void base_socket::connect_to(address_t& address, port_t port) {
+        auto e = _getaddrinfo(address, port);
+        if (e != 0) {
+            throw std::runtime_error(gai_strerror(e));
+        }
+        auto i = connect(_socket, _long_addr->ai_addr, _long_addr->ai_addrlen);
+        freeaddrinfo(_long_addr);
+        _long_addr = nullptr;
+        if (i == SOCKET_ERROR && errno != EINPROGRESS) { //a non-blocking connect completes in the background
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    void base_socket::connect_to(address_t& address, port_t port, std::chrono::milliseconds timeout) {
+        if (timeout <= NO_TIMEOUT) {
+            connect_to(address, port);
+            return;
+        }
+        auto flags = fcntl(_socket, F_GETFL);
+        if (flags == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+        auto blocking = (flags & O_NONBLOCK) == 0;
+        if (blocking) {
+            be_non_blocking();
+        }
+        connect_to(address, port);
+        struct pollfd p = { _socket, POLLOUT, 0 };
+        int i;
+        while ((i = poll(&p, 1, static_cast<int>(timeout.count()))) == SOCKET_ERROR && errno == EINTR) {}
+        if (i == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+        if (i == 0) {
+            throw std::runtime_error("connect to " + address + " timed out");
+        }
+        int error = 0;
+        socklen_t len = sizeof(error);
+        if (getsockopt(_socket, SOL_SOCKET, SO_ERROR, &error, &len) == SOCKET_ERROR || error != 0) {
+            errno = error ? error : errno;
+            throw std::runtime_error(make_error_message());
+        }
+        if (blocking) {
+            int mode = 0;
+            if (ioctl(_socket, FIONBIO, &mode) == SOCKET_ERROR) {
+                throw std::runtime_error(make_error_message());
+            }
+        }
+    }
+
+    void base_socket::deadline(std::chrono::milliseconds timeout) {
+        struct timeval tv;
+        tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+        tv.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);     //all zero waits indefinitely
+        if (setsockopt(_socket, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) == SOCKET_ERROR ||
+            setsockopt(_socket, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)) == SOCKET_ERROR)
+        {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    void base_socket::no_delay(bool on) {
+        int optval = on ? 1 : 0;
+        if (setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, &optval, sizeof(optval)) == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    void base_socket::cork(bool on) {
+        int optval = on ? 1 : 0;
+        if (setsockopt(_socket, IPPROTO_TCP, TCP_CORK, &optval, sizeof(optval)) == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    void base_socket::be_non_blocking() {
+        //FIONBIO enables or disables the blocking mode for the socket based on the value of mode.
+        // 0 = blocking is enabled
+        // 1 = non-blocking mode is enabled.
+        // one ioctl rather than the fcntl F_GETFL/F_SETFL pair
+        int mode = 1;
+        if (ioctl(_socket, FIONBIO, &mode) == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    size_t base_socket::peek() const {
+        std::array<char, DEFAULT_BUFFER_SIZE>buffer;
+        auto i = recv(_socket, &buffer.front(), buffer.size(), MSG_PEEK);
+        _meter_call(i);
+        if (i == SOCKET_ERROR) {
+            if (would_block()) {
+                return 0;
+            }
+            throw std::runtime_error(make_error_message());
+        }
+        return i;
+    }
+
+    std::string base_socket::read(flag_t flags) const {
+        std::array<char, DEFAULT_BUFFER_SIZE>buffer;
+        errno = 0; //so that an empty string with a stale EAGAIN is not mistaken for would block
+        auto i = read(buffer.data(), buffer.size(), flags);
+        return (i > 0) ? std::string(buffer.data(), static_cast<size_t>(i)) : std::string();
+    }
+
+    long base_socket::write(address_t& buffer, flag_t flags) const {
+        return write(buffer.data(), buffer.size(), flags);
+    }
+
+    long base_socket::read(char* buffer, size_t length, flag_t flags) const {
+        auto i = recv(_socket, buffer, length, flags);
+        _meter(direction_t::IN, i);
+        if (i == SOCKET_ERROR && !would_block()) {
+            throw std::runtime_error(make_error_message());
+        }
+        return i;
+    }
+
+    long base_socket::write(const char* buffer, size_t length, flag_t flags) const {
+        //MSG_NOSIGNAL - a peer that has gone away is reported as EPIPE rather than killing the process with SIGPIPE
+        auto i = send(_socket, buffer, length, flags | MSG_NOSIGNAL);
+        _meter(direction_t::OUT, i);
+        if (i == SOCKET_ERROR && !would_block()) {
+            throw std::runtime_error(make_error_message());
+        }
+        return i;
+    }
+
+    std::string base_socket::read_from(flag_t flags) {
+        std::array<char, DEFAULT_BUFFER_SIZE> buffer;
+        errno = 0;
+        auto i = read_from(buffer.data(), buffer.size(), flags);
+        return (i > 0) ? std::string(buffer.data(), static_cast<size_t>(i)) : std::string();
+    }
+
+    long base_socket::write_back(const std::string& buffer, flag_t flags) {
+        return write_back(buffer.data(), buffer.size(), flags);
+    }
+
+    long base_socket::read_from(char* buffer, size_t length, flag_t flags) {
+        socklen_t len_raddr = sizeof(_raddr);
+        auto i = recvfrom(_socket,
+            buffer,
+            length,
+            flags,
+            reinterpret_cast<struct sockaddr*>(&_raddr),
+            &len_raddr);
+        _meter(direction_t::IN, i);
+        if (i == SOCKET_ERROR && !would_block()) { //return the number of bytes received, or -1 if an error occurred.
+            throw std::runtime_error(make_error_message());
+        }
+        return i;
+    }
+
+    long base_socket::write_back(const char* buffer, size_t length, flag_t flags) {
+        //transmit message in buffer
+        auto i = sendto(_socket,
+            buffer,
+            length,
+            flags | MSG_NOSIGNAL,
+            reinterpret_cast<struct sockaddr*>(&_raddr),
+            sizeof(_raddr));
+        _meter(direction_t::OUT, i);
+        if (i == SOCKET_ERROR && !would_block()) { //return the number of bytes sent, or -1 if an error occurred.
+            throw std::runtime_error(make_error_message());
+        }
+        return i;
+    }
+
+    long base_socket::write_v(const const_buffer* buffers, size_t count, flag_t flags) const {
+        io_vectors_t iov;
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov.data();
+        msg.msg_iovlen = _gather(buffers, count, iov);
+        //sendmsg rather than writev as it takes flags, MSG_NOSIGNAL as for write
+        auto i = sendmsg(_socket, &msg, flags | MSG_NOSIGNAL);
+        _meter(direction_t::OUT, i);
+        if (i == SOCKET_ERROR && !would_block()) {
+            throw std::runtime_error(make_error_message());
+        }
+        return i;
+    }
+
+    long base_socket::read_v(const mutable_buffer* buffers, size_t count, flag_t flags) const {
+        io_vectors_t iov;
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov.data();
+        msg.msg_iovlen = _gather(buffers, count, iov);
+        auto i = recvmsg(_socket, &msg, flags);
+        _meter(direction_t::IN, i);
+        if (i == SOCKET_ERROR && !would_block()) {
+            throw std::runtime_error(make_error_message());
+        }
+        return i;
+    }
+
+    long base_socket::write_back_v(const const_buffer* buffers, size_t count, flag_t flags) {
+        if (count > MAX_IO_VECTORS) {
+            throw std::runtime_error("write_back_v: too many buffers for one datagram");
+        }
+        io_vectors_t iov;
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &_raddr;
+        msg.msg_namelen = sizeof(_raddr);
+        msg.msg_iov = iov.data();
+        msg.msg_iovlen = _gather(buffers, count, iov);
+        auto i = sendmsg(_socket, &msg, flags | MSG_NOSIGNAL);
+        _meter(direction_t::OUT, i);
+        if (i == SOCKET_ERROR && !would_block()) {
+            throw std::runtime_error(make_error_message());
+        }
+        return i;
+    }
+
+    long base_socket::read_from_v(const mutable_buffer* buffers, size_t count, flag_t flags) {
+        io_vectors_t iov;
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &_raddr;
+        msg.msg_namelen = sizeof(_raddr);
+        msg.msg_iov = iov.data();
+        msg.msg_iovlen = _gather(buffers, count, iov);
+        auto i = recvmsg(_socket, &msg, flags);
+        _meter(direction_t::IN, i);
+        if (i == SOCKET_ERROR && !would_block()) {
+            throw std::runtime_error(make_error_message());
+        }
+        return i;
+    }
+
+    std::string base_socket::hostname() const
+    {
+        std::array<char, HOST_NAME_MAX + 1> name;
+        if (gethostname(name.data(), name.size()) == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+        name.back() = '\0';
+        return std::string(name.data());
+    }
+
+    void base_socket::reset() {
+        int optval = 1;             //option data depends on command here 1 enables reuse
+        if (setsockopt(_socket,
+            SOL_SOCKET,       //manipulates options at the sockets API level
+            SO_REUSEADDR,     //Enables fast restart by telling kernel to reuse even if busy
+            &optval,
+            sizeof(optval)) == SOCKET_ERROR)
+        {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    void base_socket::share_port() {
+        int optval = 1;
+        if (setsockopt(_socket,
+            SOL_SOCKET,
+            SO_REUSEPORT,     //every socket bound to the address and port gets a share of the incoming connections
+            &optval,
+            sizeof(optval)) == SOCKET_ERROR)
+        {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    void base_socket::set_option(int level, int name, int value) {
+        if (setsockopt(_socket, level, name, &value, sizeof(value)) == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    void base_socket::stop(action_t action) {
+        switch (action) {
+        case action_t::WRITE:
+            if (shutdown(_socket, SHUT_WR) < 0) {
+                throw std::runtime_error(make_error_message());
+            }
+            break;
+        case action_t::READ:
+            if (shutdown(_socket, SHUT_RD) < 0) {
+                throw std::runtime_error(make_error_message());
+            }
+            break;
+        case action_t::READ_AND_WRITE:
+            if (shutdown(_socket, SHUT_RDWR) < 0) {
+                throw std::runtime_error(make_error_message());
+            }
+            break;
+        }
+    }
+
+    long base_socket::read_batch(datagram_t* datagrams, size_t count, flag_t flags) {
+        std::array<struct mmsghdr, MAX_BATCH_DATAGRAMS> msgs;
+        std::array<struct iovec, MAX_BATCH_DATAGRAMS> iov;
+        auto n = (count < msgs.size()) ? count : msgs.size();
+        memset(msgs.data(), 0, n * sizeof(struct mmsghdr));
+        for (size_t i = 0; i < n; ++i) {
+            iov[i].iov_base = datagrams[i].data;
+            iov[i].iov_len = datagrams[i].capacity;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &datagrams[i].peer;
+            msgs[i].msg_hdr.msg_namelen = sizeof(datagrams[i].peer);
+        }
+        //MSG_WAITFORONE - a blocking socket returns once it has one datagram instead of waiting to fill the batch
+        auto received = recvmmsg(_socket, msgs.data(), static_cast<unsigned int>(n), flags | MSG_WAITFORONE, nullptr);
+        _meter_call(received);
+        if (received == SOCKET_ERROR) {
+            if (!would_block()) {
+                throw std::runtime_error(make_error_message());
+            }
+            return SOCKET_ERROR;
+        }
+        for (int i = 0; i < received; ++i) {
+            datagrams[i].size = msgs[i].msg_len;
+            metrics::count(counter_t::BYTES_IN, msgs[i].msg_len);
+        }
+        metrics::count(counter_t::MESSAGES_IN, static_cast<unsigned long long>(received));
+        return received;
+    }
+
+    long base_socket::write_batch(const datagram_t* datagrams, size_t count, flag_t flags) {
+        std::array<struct mmsghdr, MAX_BATCH_DATAGRAMS> msgs;
+        std::array<struct iovec, MAX_BATCH_DATAGRAMS> iov;
+        auto n = (count < msgs.size()) ? count : msgs.size();
+        memset(msgs.data(), 0, n * sizeof(struct mmsghdr));
+        for (size_t i = 0; i < n; ++i) {
+            iov[i].iov_base = datagrams[i].data;
+            iov[i].iov_len = datagrams[i].size;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = const_cast<struct sockaddr_in*>(&datagrams[i].peer);
+            msgs[i].msg_hdr.msg_namelen = sizeof(datagrams[i].peer);
+        }
+        auto sent = sendmmsg(_socket, msgs.data(), static_cast<unsigned int>(n), flags | MSG_NOSIGNAL);
+        _meter_call(sent);
+        if (sent == SOCKET_ERROR && !would_block()) {
+            throw std::runtime_error(make_error_message());
+        }
+        for (int i = 0; i < sent; ++i) {
+            metrics::count(counter_t::BYTES_OUT, msgs[i].msg_len);
+        }
+        if (sent > 0) {
+            metrics::count(counter_t::MESSAGES_OUT, static_cast<unsigned long long>(sent));
+        }
+        return sent;
+    }
+
+    void base_socket::segment_offload(unsigned short segment_size) {
+        int optval = segment_size;
+        if (setsockopt(_socket,
+            SOL_UDP,
+            UDP_SEGMENT,    //every send is split into datagrams of this size by the kernel, or by the NIC if it can
+            &optval,
+            sizeof(optval)) == SOCKET_ERROR)
+        {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    void base_socket::receive_offload() {
+        int optval = 1;
+        if (setsockopt(_socket,
+            SOL_UDP,
+            UDP_GRO,        //datagrams may arrive coalesced, the segment size comes as a control message
+            &optval,
+            sizeof(optval)) == SOCKET_ERROR)
+        {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    long base_socket::read_from_segments(char* buffer, size_t length, unsigned short& segment_size, flag_t flags) {
+        struct iovec iov = { buffer, length };
+        std::array<char, CMSG_SPACE(sizeof(int))> control;
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &_raddr;
+        msg.msg_namelen = sizeof(_raddr);
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+        auto i = recvmsg(_socket, &msg, flags);
+        _meter(direction_t::IN, i);
+        if (i == SOCKET_ERROR) {
+            if (!would_block()) {
+                throw std::runtime_error(make_error_message());
+            }
+            return i;
+        }
+        segment_size = static_cast<unsigned short>(i);  //a single datagram unless the kernel says it coalesced
+        for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                int gso_size;
+                memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+                segment_size = static_cast<unsigned short>(gso_size);
+            }
+        }
+        return i;
+    }
+
+    long base_socket::send_file(int file, long long offset, size_t length) {
+        off_t off = static_cast<off_t>(offset);
+        auto i = sendfile(_socket, file, &off, length);
+        _meter(direction_t::OUT, i);
+        if (i == SOCKET_ERROR && !would_block()) {
+            throw std::runtime_error(make_error_message());
+        }
+        return i;
+    }
+
+    void base_socket::zero_copy(size_t threshold) {
+        int optval = (threshold > 0) ? 1 : 0;
+        if (setsockopt(_socket,
+            SOL_SOCKET,
+            SO_ZEROCOPY,    //without it MSG_ZEROCOPY is silently ignored
+            &optval,
+            sizeof(optval)) == SOCKET_ERROR)
+        {
+            throw std::runtime_error(make_error_message());
+        }
+        _zero_copy_threshold = threshold;
+    }
+
+    long base_socket::write_zero_copy(const char* buffer, size_t length, zero_copy_t& token, flag_t flags) {
+        token = 0;
+        if (_zero_copy_threshold == 0 || length < _zero_copy_threshold) {
+            return write(buffer, length, flags);
+        }
+        auto i = send(_socket, buffer, length, flags | MSG_NOSIGNAL | MSG_ZEROCOPY);
+        _meter(direction_t::OUT, i);
+        if (i == SOCKET_ERROR) {
+            //ENOBUFS - over the locked memory limit for pinned pages, copy this one instead
+            if (errno == ENOBUFS) {
+                return write(buffer, length, flags);
+            }
+            if (!would_block()) {
+                throw std::runtime_error(make_error_message());
+            }
+            return i;
+        }
+        //every zero copy send that takes bytes is numbered, from 0, by the kernel
+        token = ++_zero_copy_sent;
+        return i;
+    }
+
+    bool base_socket::is_sent(zero_copy_t token) {
+        while (token > _zero_copy_completed) {
+            std::array<char, CMSG_SPACE(sizeof(struct sock_extended_err))> control;
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_control = control.data();
+            msg.msg_controllen = control.size();
+            //the error queue never blocks, EAGAIN just means nothing more has completed yet
+            auto i = recvmsg(_socket, &msg, MSG_ERRQUEUE);
+            _meter_call(i);
+            if (i == SOCKET_ERROR) {
+                if (!would_block()) {
+                    throw std::runtime_error(make_error_message());
+                }
+                return false;
+            }
+            for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+                struct sock_extended_err err;
+                memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+                if (err.ee_errno != 0 || err.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                    continue;
+                }
+                //ee_data is the 32 bit number of the last send in the completed range, widen it to our count
+                auto delta = static_cast<unsigned int>(err.ee_data + 1 - static_cast<unsigned int>(_zero_copy_completed));
+                if (delta < 0x80000000u) {
+                    _zero_copy_completed += delta;
+                }
+            }
+        }
+        return true;
+    }
+
+    int base_socket::_getaddrinfo(const std::string& address, const unsigned short port) {
+        // get server ip fit args
+        return getaddrinfo(address.c_str(), std::to_string(port).c_str(), &_hints, &_long_addr);
+    }
+
+}   /*! @} */
+
+#endif
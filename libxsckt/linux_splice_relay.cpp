@@ -0,0 +1,71 @@
+#ifdef __linux__
+
+#include "linux_splice_relay.h"
+
+#include <fcntl.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    splice_relay::splice_relay(const size_t capacity) {
+        if (pipe2(_pipe, O_NONBLOCK | O_CLOEXEC) == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+        //the kernel rounds the size up to whole pages, and may refuse beyond /proc/sys/fs/pipe-max-size
+        auto size = fcntl(_pipe[1], F_SETPIPE_SZ, static_cast<int>(capacity));
+        if (size == SOCKET_ERROR) {
+            size = fcntl(_pipe[1], F_GETPIPE_SZ);
+        }
+        _capacity = static_cast<size_t>(size);
+    }
+
+    splice_relay::~splice_relay() {
+        close(_pipe[0]);
+        close(_pipe[1]);
+    }
+
+    long splice_relay::transfer(sockfd_t from, sockfd_t to, size_t length) {
+        auto ended = false;
+        if (_pending < _capacity && length > 0) {
+            auto n = splice(from, nullptr, _pipe[1], nullptr, std::min(length, _capacity - _pending), SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (n > 0) {
+                _pending += static_cast<size_t>(n);
+            }
+            else if (n == 0) {
+                ended = true;
+            }
+            else if (!would_block()) {
+                throw std::runtime_error(make_error_message());
+            }
+        }
+        if (_pending == 0) {
+            if (ended) {
+                return 0;
+            }
+            errno = EAGAIN;
+            return SOCKET_ERROR;
+        }
+        auto i = splice(_pipe[0], nullptr, to, nullptr, _pending, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (i == SOCKET_ERROR) {
+            if (!would_block()) {
+                throw std::runtime_error(make_error_message());
+            }
+            return SOCKET_ERROR;
+        }
+        _pending -= static_cast<size_t>(i);
+        return i;
+    }
+
+    size_t splice_relay::pending() const {
+        return _pending;
+    }
+
+}   /*! @} */
+
+#endif
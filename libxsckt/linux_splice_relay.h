@@ -0,0 +1,62 @@
+#pragma once
+
+#ifdef __linux__
+
+#include "xsckt.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief The splice_relay class moves bytes from one descriptor to another, socket or pipe, without copying them through user memory.
+     * @version 0.1
+     * splice needs a pipe at one end, so the relay owns one and the bytes pass from the source into the pipe and out to the
+     * destination inside the kernel. Bytes the destination would not take yet stay in the pipe for the next transfer, so with
+     * non-blocking sockets transfer can be called from an event loop's on_readable and on_writable alike.
+     * @note not thread safe - one splice_relay per direction of a proxied connection
+     */
+    class splice_relay {
+
+    public:
+
+        /**
+         * @brief splice_relay - creates the pipe
+         * @param capacity - requested pipe size, the most a transfer can move and hold back
+         */
+        explicit splice_relay(const size_t capacity = LARGE_BUFFER_SIZE);
+
+        splice_relay(const splice_relay&) = delete;
+
+        splice_relay& operator= (const splice_relay&) = delete;
+
+        ~splice_relay();
+
+        /**
+         * @brief transfer - move what from has ready, up to length bytes, and pass on what to will take
+         * @param from - source socket or pipe
+         * @param to - destination socket or pipe
+         * @param length - most bytes to take from the source
+         * @return long - bytes passed to the destination, 0 once the source has ended and nothing is held back,
+         * -1 with would_block() true if neither side was ready
+         */
+        long transfer(sockfd_t from, sockfd_t to, size_t length = LARGE_BUFFER_SIZE);
+
+        /**
+         * @brief pending - bytes taken from the source that the destination has not taken yet
+         */
+        size_t pending() const;
+
+    private:
+
+        int _pipe[2];
+        size_t _capacity;
+        size_t _pending{ 0 };
+
+    };
+
+}   /*! @} */
+
+#endif
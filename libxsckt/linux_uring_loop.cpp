@@ -0,0 +1,282 @@
+#if defined(__linux__) && defined(XSCKT_IO_URING)
+
+#include "linux_uring_loop.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    static const unsigned short BUFFER_GROUP = 0;
+
+    uring_loop::uring_loop(const unsigned int entries, const unsigned int buffers, const unsigned int buffer_size) :
+        _buf_count(buffers),
+        _buf_size(buffer_size),
+        _buffers(static_cast<size_t>(buffers) * buffer_size)
+    {
+        assert(buffers > 0 && (buffers & (buffers - 1)) == 0 && buffers <= 32768);
+        struct io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        _ring = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (_ring == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+        _sq_entries = params.sq_entries;
+        //map the rings - since 5.4 the submission and completion rings share one mapping
+        _sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        _cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            _sq_size = _cq_size = std::max(_sq_size, _cq_size);
+        }
+        _sq_ptr = mmap(nullptr, _sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQ_RING);
+        if (_sq_ptr == MAP_FAILED) {
+            _sq_ptr = nullptr;
+            _release();
+            throw std::runtime_error(make_error_message());
+        }
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            _cq_ptr = _sq_ptr;
+        }
+        else {
+            _cq_ptr = mmap(nullptr, _cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_CQ_RING);
+            if (_cq_ptr == MAP_FAILED) {
+                _cq_ptr = nullptr;
+                _release();
+                throw std::runtime_error(make_error_message());
+            }
+        }
+        _sqes = static_cast<struct io_uring_sqe*>(mmap(nullptr, params.sq_entries * sizeof(struct io_uring_sqe),
+            PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQES));
+        if (_sqes == MAP_FAILED) {
+            _sqes = nullptr;
+            _release();
+            throw std::runtime_error(make_error_message());
+        }
+        auto sq = static_cast<char*>(_sq_ptr);
+        _sq_head = reinterpret_cast<unsigned int*>(sq + params.sq_off.head);
+        _sq_tail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+        _sq_mask = *reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+        _sq_array = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+        auto cq = static_cast<char*>(_cq_ptr);
+        _cq_head = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+        _cq_tail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+        _cq_mask = *reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        //register the read buffers with the kernel once, reads then pick a free one as data arrives
+        _buf_ring_size = _buf_count * sizeof(struct io_uring_buf);
+        auto ring = mmap(nullptr, _buf_ring_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        if (ring == MAP_FAILED) {
+            _release();
+            throw std::runtime_error(make_error_message());
+        }
+        _buf_ring = static_cast<struct io_uring_buf_ring*>(ring);
+        struct io_uring_buf_reg reg;
+        memset(&reg, 0, sizeof(reg));
+        reg.ring_addr = reinterpret_cast<unsigned long long>(_buf_ring);
+        reg.ring_entries = _buf_count;
+        reg.bgid = BUFFER_GROUP;
+        if (syscall(__NR_io_uring_register, _ring, IORING_REGISTER_PBUF_RING, &reg, 1) == SOCKET_ERROR) {
+            _release();
+            throw std::runtime_error(make_error_message());
+        }
+        for (unsigned int bid = 0; bid < _buf_count; ++bid) {
+            _recycle(static_cast<unsigned short>(bid));
+        }
+    }
+
+    uring_loop::~uring_loop() {
+        //requests still in flight are abandoned, closing the ring cancels them
+        _release();
+    }
+
+    void uring_loop::_release() {
+        if (_buf_ring) {
+            munmap(_buf_ring, _buf_ring_size);
+            _buf_ring = nullptr;
+        }
+        if (_sqes) {
+            munmap(_sqes, _sq_entries * sizeof(struct io_uring_sqe));
+            _sqes = nullptr;
+        }
+        if (_cq_ptr && _cq_ptr != _sq_ptr) {
+            munmap(_cq_ptr, _cq_size);
+        }
+        _cq_ptr = nullptr;
+        if (_sq_ptr) {
+            munmap(_sq_ptr, _sq_size);
+            _sq_ptr = nullptr;
+        }
+        if (_ring != INVALID_SOCKET) {
+            close(_ring);
+            _ring = INVALID_SOCKET;
+        }
+    }
+
+    void uring_loop::accept_from(sockfd_t listener, accept_handler_t on_accept) {
+        auto request = new request_t{ op_t::ACCEPT, listener, std::move(on_accept), nullptr, nullptr, std::string() };
+        _submit(request);
+    }
+
+    void uring_loop::read(sockfd_t socket, read_handler_t on_read) {
+        auto request = new request_t{ op_t::READ, socket, nullptr, std::move(on_read), nullptr, std::string() };
+        _submit(request);
+    }
+
+    void uring_loop::write(sockfd_t socket, std::string buffer, write_handler_t on_written) {
+        auto request = new request_t{ op_t::WRITE, socket, nullptr, nullptr, std::move(on_written), std::move(buffer) };
+        _submit(request);
+    }
+
+    size_t uring_loop::poll() {
+        if (_enter(_to_submit, 1) == SOCKET_ERROR && errno != EINTR) {
+            throw std::runtime_error(make_error_message());
+        }
+        size_t n = 0;
+        auto head = *_cq_head;
+        //handlers may queue more requests but never reap, so the head is ours until it is published
+        while (head != __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+            auto cqe = _cqes[head & _cq_mask];
+            ++head;
+            __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+            _dispatch(cqe);
+            ++n;
+        }
+        return n;
+    }
+
+    void uring_loop::run() {
+        _running = true;
+        while (_running) {
+            poll();
+        }
+    }
+
+    void uring_loop::stop() {
+        _running = false;
+    }
+
+    struct io_uring_sqe* uring_loop::_get_sqe() {
+        auto tail = *_sq_tail;
+        while (tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) >= _sq_entries) {
+            //submission ring full, hand what is queued to the kernel without waiting until it has taken some
+            auto i = _enter(_to_submit, 0);
+            if (i == SOCKET_ERROR && errno != EINTR) {
+                throw std::runtime_error(make_error_message());
+            }
+            if (i == 0) {
+                //nothing taken, e.g. the completion ring is backed up, and reaping here would re-enter the handlers
+                throw std::runtime_error("io_uring submission ring full");
+            }
+        }
+        auto index = tail & _sq_mask;
+        auto sqe = &_sqes[index];
+        memset(sqe, 0, sizeof(struct io_uring_sqe));
+        _sq_array[index] = index;
+        return sqe;
+    }
+
+    void uring_loop::_submit(request_t* request) {
+        auto sqe = _get_sqe();
+        sqe->fd = request->socket;
+        sqe->user_data = reinterpret_cast<unsigned long long>(request);
+        switch (request->op) {
+        case op_t::ACCEPT:
+            sqe->opcode = IORING_OP_ACCEPT;
+            sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+            sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;   //same contract as base_socket::accept_from
+            break;
+        case op_t::READ:
+            sqe->opcode = IORING_OP_RECV;
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = BUFFER_GROUP;
+            break;
+        case op_t::WRITE:
+            sqe->opcode = IORING_OP_SEND;
+            sqe->addr = reinterpret_cast<unsigned long long>(request->buffer.data() + request->offset);
+            sqe->len = static_cast<unsigned int>(request->buffer.size() - request->offset);
+            sqe->msg_flags = MSG_NOSIGNAL;
+            break;
+        }
+        __atomic_store_n(_sq_tail, *_sq_tail + 1, __ATOMIC_RELEASE);
+        ++_to_submit;
+    }
+
+    int uring_loop::_enter(unsigned int to_submit, unsigned int min_complete) {
+        auto i = static_cast<int>(syscall(__NR_io_uring_enter, _ring, to_submit, min_complete,
+            min_complete ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+        if (i > 0) {
+            _to_submit -= static_cast<unsigned int>(i);
+        }
+        return i;
+    }
+
+    void uring_loop::_dispatch(const struct io_uring_cqe& cqe) {
+        auto request = reinterpret_cast<request_t*>(cqe.user_data);
+        auto more = (cqe.flags & IORING_CQE_F_MORE) != 0;   //a multishot request stays armed
+        switch (request->op) {
+        case op_t::ACCEPT:
+            request->on_accept(cqe.res);
+            if (!more) {
+                if (cqe.res >= 0 || cqe.res == -ENFILE || cqe.res == -EMFILE) {
+                    _submit(request);   //the kernel dropped the multishot, re-arm it
+                    return;
+                }
+                delete request;
+            }
+            return;
+        case op_t::READ:
+            if (cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER)) {
+                auto bid = static_cast<unsigned short>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                request->on_read(request->socket, &_buffers[static_cast<size_t>(bid) * _buf_size], cqe.res);
+                _recycle(bid);
+            }
+            else if (cqe.res != -ENOBUFS) {
+                request->on_read(request->socket, nullptr, cqe.res);
+            }
+            if (!more) {
+                if (cqe.res > 0 || cqe.res == -ENOBUFS) {
+                    _submit(request);   //out of buffers or dropped by the kernel, not the end of the stream
+                    return;
+                }
+                delete request;
+            }
+            return;
+        case op_t::WRITE:
+            if (cqe.res > 0 && request->offset + static_cast<size_t>(cqe.res) < request->buffer.size()) {
+                request->offset += static_cast<size_t>(cqe.res);
+                _submit(request);       //short write, send the rest
+                return;
+            }
+            if (request->on_written) {
+                request->on_written(request->socket, (cqe.res < 0) ? cqe.res : static_cast<long>(request->buffer.size()));
+            }
+            delete request;
+            return;
+        }
+    }
+
+    void uring_loop::_recycle(unsigned short bid) {
+        //io_uring_buf_ring::bufs is a flexible array that C++ compiles at the wrong offset, so index the ring directly
+        auto bufs = reinterpret_cast<struct io_uring_buf*>(_buf_ring);
+        auto& buf = bufs[_buf_tail & (_buf_count - 1)];
+        buf.addr = reinterpret_cast<unsigned long long>(&_buffers[static_cast<size_t>(bid) * _buf_size]);
+        buf.len = _buf_size;
+        buf.bid = bid;
+        ++_buf_tail;
+        //the ring tail overlays the first entry's resv field
+        __atomic_store_n(&bufs[0].resv, _buf_tail, __ATOMIC_RELEASE);
+    }
+
+}   /*! @} */
+
+#endif
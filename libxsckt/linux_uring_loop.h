@@ -0,0 +1,155 @@
+#pragma once
+
+#if defined(__linux__) && defined(XSCKT_IO_URING)
+
+#include <linux/io_uring.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "xsckt.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief The uring_loop class is an io_uring completion loop for accepts, reads and writes on the calling thread.
+     * @version 0.1
+     * Requests are queued in the submission ring and handed to the kernel in one batch by poll, which reaps every
+     * completion in the same io_uring_enter system call. Accepts and reads are multishot so stay armed, and reads
+     * land in a ring of kernel provided buffers registered once up front, so no per-read buffer is allocated.
+     * @note built on the raw io_uring system calls (define XSCKT_IO_URING to compile it), needs Linux 6.0+ for multishot recv
+     * @note not thread safe - one uring_loop per thread
+     */
+    class uring_loop {
+
+    public:
+
+        /**
+         * @brief accept_handler_t - called with each accepted SOCK_NONBLOCK | SOCK_CLOEXEC socket, or -errno on failure
+         */
+        using accept_handler_t = std::function<void(sockfd_t)>;
+
+        /**
+         * @brief read_handler_t - called with each chunk read (valid only for the duration of the call), 0 at end of stream or -errno
+         */
+        using read_handler_t = std::function<void(sockfd_t, const char*, long)>;
+
+        /**
+         * @brief write_handler_t - called once the whole buffer is written with its size, or -errno
+         */
+        using write_handler_t = std::function<void(sockfd_t, long)>;
+
+        /**
+         * @brief uring_loop - sets up the rings and registers the read buffers
+         * @param entries - submission ring size
+         * @param buffers - number of read buffers (power of 2)
+         * @param buffer_size - size of each read buffer
+         */
+        explicit uring_loop(const unsigned int entries = DEFAULT_RING_ENTRIES,
+            const unsigned int buffers = DEFAULT_RING_BUFFERS,
+            const unsigned int buffer_size = DEFAULT_RING_BUFFER_SIZE);
+
+        uring_loop(const uring_loop&) = delete;
+
+        uring_loop& operator= (const uring_loop&) = delete;
+
+        ~uring_loop();
+
+        /**
+         * @brief accept_from - keep accepting connections on a listening socket
+         */
+        void accept_from(sockfd_t listener, accept_handler_t on_accept);
+
+        /**
+         * @brief read - keep reading from a connected socket until the end of stream or an error
+         */
+        void read(sockfd_t socket, read_handler_t on_read);
+
+        /**
+         * @brief write - write the whole buffer, resubmitting after short writes
+         * @note two writes in flight on one socket may complete out of order, wait for on_written before the next
+         */
+        void write(sockfd_t socket, std::string buffer, write_handler_t on_written = nullptr);
+
+        /**
+         * @brief poll - submit every queued request, wait for at least one completion and dispatch all that are ready
+         * @return size_t - number of completions dispatched
+         */
+        size_t poll();
+
+        /**
+         * @brief run - dispatch completions until stop is called
+         */
+        void run();
+
+        /**
+         * @brief stop - make run return after the current batch of completions
+         */
+        void stop();
+
+    private:
+
+        enum class op_t { ACCEPT, READ, WRITE };
+
+        struct request_t {
+            op_t op;
+            sockfd_t socket;
+            accept_handler_t on_accept;
+            read_handler_t on_read;
+            write_handler_t on_written;
+            std::string buffer;
+            size_t offset{ 0 };
+        };
+
+        struct io_uring_sqe* _get_sqe();
+
+        void _submit(request_t* request);
+
+        int _enter(unsigned int to_submit, unsigned int min_complete);
+
+        void _dispatch(const struct io_uring_cqe& cqe);
+
+        void _recycle(unsigned short bid);
+
+        void _release();
+
+        int _ring;
+        bool _running{ false };
+
+        //submission ring
+        void* _sq_ptr{ nullptr };
+        size_t _sq_size{ 0 };
+        unsigned int* _sq_head;
+        unsigned int* _sq_tail;
+        unsigned int* _sq_array;
+        unsigned int _sq_mask;
+        unsigned int _sq_entries;
+        struct io_uring_sqe* _sqes{ nullptr };
+        unsigned int _to_submit{ 0 };
+
+        //completion ring
+        void* _cq_ptr{ nullptr };
+        size_t _cq_size{ 0 };
+        unsigned int* _cq_head;
+        unsigned int* _cq_tail;
+        unsigned int _cq_mask;
+        struct io_uring_cqe* _cqes;
+
+        //provided read buffers
+        struct io_uring_buf_ring* _buf_ring{ nullptr };
+        size_t _buf_ring_size{ 0 };
+        unsigned int _buf_count;
+        unsigned int _buf_size;
+        unsigned short _buf_tail{ 0 };
+        std::vector<char> _buffers;
+
+    };
+
+}   /*! @} */
+
+#endif
@@ -0,0 +1,133 @@
+#include "message_framer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    message_framer::message_framer(prefix_t prefix, size_t max_message) :
+        _prefix(prefix),
+        _max_message(max_message),
+        _buffer(buffer_pool::instance().acquire())
+    {
+    }
+
+    mutable_buffer message_framer::space(size_t min_size) {
+        //room for the rest of a message whose length is known, so a long one arrives in as few reads as the kernel allows
+        auto partial = _end - _begin;
+        if (_wanted > partial) {
+            min_size = std::max(min_size, _wanted - partial);
+        }
+        if (!_buffer.unique()) {
+            //messages in this chunk are still held, so read on in a fresh one
+            _move(std::max(partial + min_size, static_cast<size_t>(LARGE_BUFFER_SIZE)));
+        }
+        else if (partial == 0 && _buffer.capacity() > LARGE_BUFFER_SIZE && min_size <= LARGE_BUFFER_SIZE) {
+            _move(LARGE_BUFFER_SIZE);  // the long message that needed an oversize chunk has gone, give it back to the heap
+        }
+        else if (_buffer.capacity() - _end < min_size) {
+            //slide the partial message down to the front before growing, usually there is room once the parsed bytes are gone
+            if (_begin > 0) {
+                std::memmove(_buffer.data(), _buffer.data() + _begin, partial);
+                _end = partial;
+                _begin = 0;
+            }
+            if (_buffer.capacity() - _end < min_size) {
+                _move(std::max(_buffer.capacity() * 2, _end + min_size));
+            }
+        }
+        return { _buffer.data() + _end, _buffer.capacity() - _end };
+    }
+
+    void message_framer::commit(size_t n) {
+        _end += n;
+    }
+
+    void message_framer::feed(const char* data, size_t size) {
+        auto s = space(size);
+        std::memcpy(s.data, data, size);
+        commit(size);
+    }
+
+    bool message_framer::next(mutable_buffer& message) {
+        auto available = _end - _begin;
+        auto p = reinterpret_cast<const unsigned char*>(_buffer.data() + _begin);
+        size_t length = 0;
+        size_t prefix = 0;
+        if (_prefix == prefix_t::FIXED32) {
+            if (available < 4) {
+                return false;
+            }
+            length = (static_cast<size_t>(p[0]) << 24) | (static_cast<size_t>(p[1]) << 16) | (static_cast<size_t>(p[2]) << 8) | p[3];
+            prefix = 4;
+        }
+        else {
+            //LEB128 - 7 bits a byte, least significant first, the top bit set on every byte but the last
+            while (true) {
+                if (prefix == available) {
+                    return false;
+                }
+                if (prefix == MAX_PREFIX) {
+                    throw std::runtime_error("message_framer: malformed length prefix");
+                }
+                length |= static_cast<size_t>(p[prefix] & 0x7f) << (7 * prefix);
+                if (!(p[prefix++] & 0x80)) {
+                    break;
+                }
+            }
+        }
+        if (length > _max_message) {
+            throw std::runtime_error("message_framer: message longer than max_message");
+        }
+        if (available - prefix < length) {
+            _wanted = prefix + length;
+            return false;
+        }
+        _wanted = 0;
+        message = { _buffer.data() + _begin + prefix, length };
+        _begin += prefix + length;
+        if (_begin == _end) {
+            _begin = _end = 0;  //drained, the next read starts at the front again
+        }
+        return true;
+    }
+
+    size_t message_framer::buffered() const {
+        return _end - _begin;
+    }
+
+    void message_framer::_move(size_t capacity) {
+        auto chunk = buffer_pool::instance().acquire(capacity);
+        std::memcpy(chunk.data(), _buffer.data() + _begin, _end - _begin);
+        _end -= _begin;
+        _begin = 0;
+        _buffer = std::move(chunk);
+    }
+
+    size_t message_framer::encode(size_t size, char* prefix) const {
+        auto p = reinterpret_cast<unsigned char*>(prefix);
+        if (_prefix == prefix_t::FIXED32) {
+            p[0] = static_cast<unsigned char>(size >> 24);
+            p[1] = static_cast<unsigned char>(size >> 16);
+            p[2] = static_cast<unsigned char>(size >> 8);
+            p[3] = static_cast<unsigned char>(size);
+            return 4;
+        }
+        size_t n = 0;
+        do {
+            p[n] = static_cast<unsigned char>(size & 0x7f);
+            size >>= 7;
+            if (size) {
+                p[n] |= 0x80;
+            }
+            ++n;
+        } while (size);
+        return n;
+    }
+
+}   /*! @} */
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <array>
+
+#include "xsckt.h"
+#include "buffer_pool.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief The message_framer class splits a TCP byte stream into length prefixed messages.
+     * @version 0.1
+     * Bytes are read straight into its reassembly buffer, a chunk drawn from buffer_pool, then next hands out every whole
+     * message in place, however the stream was cut up: several messages from one read, or one message over many reads.
+     * Nothing is copied unless a message straddles the end of the buffer, when the partial message is moved to the front,
+     * or the chunk is still held elsewhere, see chunk.
+     * @note not thread safe - one message_framer per connection
+     */
+    class message_framer {
+
+    public:
+
+        static const size_t MAX_PREFIX = 5;     // a 32 bit length as LEB128
+
+        /**
+         * @brief message_framer
+         * @param prefix - how message lengths are encoded
+         * @param max_message - a longer length is taken as a corrupt stream and throws
+         */
+        explicit message_framer(prefix_t prefix = prefix_t::FIXED32, size_t max_message = DEFAULT_MAX_MESSAGE);
+
+        /**
+         * @brief space - room to read into at the end of the buffer, at least min_size bytes, and all the rest of a message
+         * once next has seen its length
+         * @note moves the unparsed bytes, so messages from next are only valid until it is called, unless their chunk is held
+         */
+        mutable_buffer space(size_t min_size = DEFAULT_RING_BUFFER_SIZE);
+
+        /**
+         * @brief commit - n bytes have been read into space()
+         */
+        void commit(size_t n);
+
+        /**
+         * @brief feed - copy in bytes that were read elsewhere
+         */
+        void feed(const char* data, size_t size);
+
+        /**
+         * @brief next - the next whole message, if one has arrived
+         * @param message - set to the payload in place, valid until the next call to space or feed; it may be changed there,
+         * e.g. transformed before it is echoed
+         * @return bool - false if the next message is still incomplete
+         */
+        bool next(mutable_buffer& message);
+
+        /**
+         * @brief buffered - bytes read but not yet handed out by next
+         */
+        size_t buffered() const;
+
+        /**
+         * @brief chunk - the pooled buffer the messages from next point into
+         * Holding a copy keeps them valid past the next call to space or feed, which then reads into a fresh chunk rather
+         * than over them, so a message can be handed on without copying it; the chunk goes back to the pool when the last
+         * copy is dropped.
+         */
+        const pooled_buffer& chunk() const {
+            return _buffer;
+        }
+
+        /**
+         * @brief encode - write the length prefix for a message of size bytes
+         * @param size - payload length
+         * @param prefix - at least MAX_PREFIX bytes
+         * @return size_t - length of the prefix
+         */
+        size_t encode(size_t size, char* prefix) const;
+
+        /**
+         * @brief frame - append a whole message, prefix then payload, to a byte container such as a batch of replies
+         * @param out - std::vector<char> or std::string
+         */
+        template<typename bytes_type>
+        void frame(bytes_type& out, const char* data, size_t size) const {
+            std::array<char, MAX_PREFIX> prefix;
+            out.insert(out.end(), prefix.data(), prefix.data() + encode(size, prefix.data()));
+            out.insert(out.end(), data, data + size);
+        }
+
+    private:
+
+        /**
+         * @brief _move - carry the unparsed bytes over to the front of a fresh chunk of at least capacity bytes
+         */
+        void _move(size_t capacity);
+
+        prefix_t _prefix;
+        size_t _max_message;
+        pooled_buffer _buffer;
+        size_t _begin{ 0 };     // first unparsed byte
+        size_t _end{ 0 };       // one past the last byte read
+        size_t _wanted{ 0 };    // prefix and payload of the incomplete message at _begin, 0 until its prefix has arrived
+
+    };
+
+    /**
+     * @brief The framed_socket class sends and receives length prefixed messages over any connected stream multi_socket.
+     * @version 0.1
+     * @note the socket must outlive it
+     */
+    template<XSCKT_STREAM_SOCKET socket_type>
+    class framed_socket {
+
+    public:
+
+        explicit framed_socket(socket_type& sckt, prefix_t prefix = prefix_t::FIXED32, size_t max_message = DEFAULT_MAX_MESSAGE) :
+            _sckt(sckt), _framer(prefix, max_message) {}
+
+        /**
+         * @brief read - one read from the socket, then on_message(mutable_buffer) for each whole message now buffered
+         * @note a message is valid only for the duration of the call, and may be changed in place
+         * @return long - as read: the number of bytes read, 0 at the end of the stream, -1 with would_block() true if no data is ready
+         */
+        template<typename handler_type>
+        long read(handler_type&& on_message) {
+            auto space = _framer.space();
+            auto i = _sckt.read(space.data, space.size);
+            if (i > 0) {
+                _framer.commit(static_cast<size_t>(i));
+                mutable_buffer message;
+                while (_framer.next(message)) {
+                    on_message(message);
+                }
+            }
+            return i;
+        }
+
+        /**
+         * @brief write - write a message, prefix and payload gathered into one write_v without concatenating them
+         * @note keeps writing until the whole message has gone, so meant for blocking sockets; non-blocking callers can
+         * queue message_framer::encode output ahead of the payload themselves
+         * @return long - the number of bytes written, prefix included
+         */
+        long write(const char* data, size_t size) {
+            std::array<char, message_framer::MAX_PREFIX> prefix;
+            std::array<const_buffer, 2> frame = { { { prefix.data(), _framer.encode(size, prefix.data()) }, { data, size } } };
+            auto total = static_cast<long>(frame[0].size + size);
+            auto buffers = frame.data();
+            auto count = frame.size();
+            while (true) {
+                auto i = _sckt.write_v(buffers, count);
+                if (consume(buffers, count, (i > 0) ? static_cast<size_t>(i) : 0)) {
+                    return total;
+                }
+            }
+        }
+
+        /**
+         * @brief framer - the parser, e.g. to check what is still buffered or to feed it bytes read elsewhere
+         */
+        message_framer& framer() {
+            return _framer;
+        }
+
+        const message_framer& framer() const {
+            return _framer;
+        }
+
+    private:
+
+        socket_type& _sckt;
+        message_framer _framer;
+
+    };
+
+}   /*! @} */
@@ -0,0 +1,126 @@
+#include "metrics.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    static const char* COUNTER_NAMES[COUNTERS] = {
+        "bytes_in", "bytes_out", "messages_in", "messages_out", "syscalls",
+        "would_block", "errors", "accepts", "connections_opened", "connections_closed"
+    };
+
+    //------------metrics_snapshot implementation------------
+    long long metrics_snapshot::live_connections() const {
+        return static_cast<long long>((*this)[counter_t::CONNECTIONS_OPENED]) - static_cast<long long>((*this)[counter_t::CONNECTIONS_CLOSED]);
+    }
+
+    double metrics_snapshot::rate(counter_t counter, const metrics_snapshot& earlier) const {
+        auto elapsed = seconds - earlier.seconds;
+        return (elapsed > 0) ? static_cast<double>((*this)[counter] - earlier[counter]) / elapsed : 0.0;
+    }
+
+    std::string metrics_snapshot::text() const {
+        std::stringstream ss;
+        for (size_t c = 0; c < COUNTERS; ++c) {
+            ss << "xsckt_" << COUNTER_NAMES[c] << " " << counters[c] << "\n";
+        }
+        ss << "xsckt_live_connections " << live_connections() << "\n";
+        ss << std::fixed << std::setprecision(3) << "xsckt_uptime_seconds " << seconds << "\n";
+        ss << "xsckt_handler_latency " << handler_latency.report(1000.0, "us") << "\n";
+        return ss.str();
+    }
+
+    //------------metrics implementation------------
+#ifdef XSCKT_NO_METRICS
+
+    metrics_snapshot metrics::snapshot() {
+        return metrics_snapshot();
+    }
+
+#else
+
+    /**
+     * @brief registry - every live thread's block, and the totals of those that have gone
+     * @note never destroyed, threads may still exit after static destruction has begun
+     */
+    struct metrics::registry {
+        std::mutex lock;
+        std::vector<thread_block*> blocks;
+        std::array<unsigned long long, COUNTERS> retired{};
+        latency_histogram retired_latency{ HIGHEST_LATENCY };
+        std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+    };
+
+    metrics::registry& metrics::_registry() {
+        static registry* r = new registry;
+        return *r;
+    }
+
+    thread_local metrics::thread_block metrics::_block;
+
+    metrics::thread_block::thread_block() {
+        //made on a thread's first count, which may be between a failed syscall and its errno being read
+        auto saved = errno;
+        auto& r = _registry();
+        {
+            std::lock_guard<std::mutex> lock(r.lock);
+            r.blocks.push_back(this);
+        }
+        errno = saved;
+    }
+
+    metrics::thread_block::~thread_block() {
+        auto& r = _registry();
+        std::lock_guard<std::mutex> lock(r.lock);
+        for (size_t c = 0; c < COUNTERS; ++c) {
+            r.retired[c] += counters[c].load(std::memory_order_relaxed);
+        }
+        if (latency) {
+            r.retired_latency.merge(*latency);
+        }
+        r.blocks.erase(std::find(r.blocks.begin(), r.blocks.end(), this));
+    }
+
+    void metrics::record_latency(unsigned long long ns) {
+        std::lock_guard<std::mutex> lock(_block.latency_lock);
+        if (!_block.latency) {
+            _block.latency = std::make_unique<latency_histogram>(HIGHEST_LATENCY);
+        }
+        _block.latency->record(ns);
+    }
+
+    metrics_snapshot metrics::snapshot() {
+        metrics_snapshot s;
+        s.handler_latency = latency_histogram(HIGHEST_LATENCY);
+        auto& r = _registry();
+        std::lock_guard<std::mutex> lock(r.lock);
+        s.counters = r.retired;
+        s.handler_latency.merge(r.retired_latency);
+        for (auto block : r.blocks) {
+            for (size_t c = 0; c < COUNTERS; ++c) {
+                s.counters[c] += block->counters[c].load(std::memory_order_relaxed);
+            }
+            std::lock_guard<std::mutex> latency_lock(block->latency_lock);
+            if (block->latency) {
+                s.handler_latency.merge(*block->latency);
+            }
+        }
+        s.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - r.start).count();
+        return s;
+    }
+
+#endif // XSCKT_NO_METRICS
+
+    std::string metrics::report() {
+        return snapshot().text();
+    }
+
+}   /*! @} */
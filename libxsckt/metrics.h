@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "latency_histogram.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief counter_t - what metrics counts
+     * MESSAGES_IN/OUT are the reads and writes that moved bytes, SYSCALLS every read, write and accept issued, WOULD_BLOCK
+     * those a non-blocking socket was not ready for, and ERRORS those that failed outright. CONNECTIONS_OPENED/CLOSED are
+     * counted by servers as they take on and drop clients.
+     */
+    enum class counter_t { BYTES_IN, BYTES_OUT, MESSAGES_IN, MESSAGES_OUT, SYSCALLS, WOULD_BLOCK, ERRORS, ACCEPTS, CONNECTIONS_OPENED, CONNECTIONS_CLOSED };
+
+    enum class direction_t { IN, OUT };
+
+    static const size_t COUNTERS = 10;
+
+    /**
+     * @brief metrics_snapshot - every thread's counters and handler latencies added up at one moment
+     */
+    struct metrics_snapshot {
+        std::array<unsigned long long, COUNTERS> counters{};
+        latency_histogram handler_latency;  // ns from a request being read to its reply being written
+        double seconds{ 0 };                // since metering started
+
+        unsigned long long operator[] (counter_t counter) const {
+            return counters[static_cast<size_t>(counter)];
+        }
+
+        /**
+         * @brief live_connections - the open connections gauge
+         */
+        long long live_connections() const;
+
+        /**
+         * @brief rate - per second change of counter since earlier
+         */
+        double rate(counter_t counter, const metrics_snapshot& earlier) const;
+
+        /**
+         * @brief text - one "xsckt_<name> <value>" line per counter, the connection gauge and the latency quantiles in us
+         */
+        std::string text() const;
+    };
+
+    /**
+     * @brief The metrics class counts socket and server activity for the whole process.
+     * @version 0.1
+     * Each thread counts into its own block, with relaxed loads and stores that no other thread writes, so counting is an
+     * add to a cache line the thread already owns; snapshot adds up the blocks of every thread, and those of threads that
+     * have exited, when asked. Handler latencies go into a per thread histogram behind a lock only a snapshot contends.
+     * Building with XSCKT_NO_METRICS leaves every call an empty inline function.
+     */
+    class metrics {
+
+    public:
+
+        static constexpr unsigned long long HIGHEST_LATENCY = 10000000000ULL;  // 10s in ns, slower handlers share the top bucket
+
+#ifdef XSCKT_NO_METRICS
+
+        static void count(counter_t, unsigned long long = 1) {}
+
+        static void call(long, bool) {}
+
+        static void io(direction_t, long, bool) {}
+
+        static unsigned long long now() {
+            return 0;
+        }
+
+        static void record_latency(unsigned long long) {}
+
+#else
+
+        /**
+         * @brief count - add n to counter
+         */
+        static void count(counter_t counter, unsigned long long n = 1) {
+            auto& value = _block.counters[static_cast<size_t>(counter)];
+            value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief call - count a syscall that returned result, a negative result as a failure
+         * @param blocked - it failed only because a non-blocking socket was not ready
+         */
+        static void call(long result, bool blocked) {
+            count(counter_t::SYSCALLS);
+            if (result < 0) {
+                count(blocked ? counter_t::WOULD_BLOCK : counter_t::ERRORS);
+            }
+        }
+
+        /**
+         * @brief io - count a read or write syscall that returned result, as call, and the bytes it moved
+         */
+        static void io(direction_t direction, long result, bool blocked) {
+            call(result, blocked);
+            if (result > 0) {
+                count((direction == direction_t::IN) ? counter_t::BYTES_IN : counter_t::BYTES_OUT, static_cast<unsigned long long>(result));
+                count((direction == direction_t::IN) ? counter_t::MESSAGES_IN : counter_t::MESSAGES_OUT);
+            }
+        }
+
+        /**
+         * @brief now - a steady clock in ns to time handlers with, 0 if metrics are compiled out
+         */
+        static unsigned long long now() {
+            return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        /**
+         * @brief record_latency - add one handler latency in ns
+         */
+        static void record_latency(unsigned long long ns);
+
+#endif // XSCKT_NO_METRICS
+
+        /**
+         * @brief snapshot - the process totals now, all zero if metrics are compiled out
+         */
+        static metrics_snapshot snapshot();
+
+        /**
+         * @brief report - snapshot().text()
+         */
+        static std::string report();
+
+    private:
+
+        struct thread_block {
+            thread_block();
+            ~thread_block();
+            std::array<std::atomic<unsigned long long>, COUNTERS> counters{};
+            std::mutex latency_lock;
+            std::unique_ptr<latency_histogram> latency;     // made on the first record, most threads never time a handler
+        };
+
+        struct registry;
+
+        static registry& _registry();
+
+        static thread_local thread_block _block;
+
+    };
+
+}   /*! @} */
@@ -0,0 +1,39 @@
+#include "simd.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    static simd_t _detect() {
+#if defined(XSCKT_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        auto max_leaf = info[0];
+        __cpuid(info, 1);
+        auto sse2 = (info[3] & (1 << 26)) != 0;
+        auto sse42 = (info[2] & (1 << 20)) != 0;
+        auto osxsave = (info[2] & (1 << 27)) != 0;
+        auto avx2 = false;
+        if (max_leaf >= 7 && osxsave && (_xgetbv(0) & 6) == 6) {    //the OS saves the ymm registers
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+        return (avx2 && sse42) ? simd_t::AVX2 : sse42 ? simd_t::SSE42 : sse2 ? simd_t::SSE2 : simd_t::SCALAR;
+#elif defined(XSCKT_X86)
+        __builtin_cpu_init();
+        return (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("sse4.2")) ? simd_t::AVX2
+            : __builtin_cpu_supports("sse4.2") ? simd_t::SSE42
+            : __builtin_cpu_supports("sse2") ? simd_t::SSE2 : simd_t::SCALAR;
+#else
+        return simd_t::SCALAR;
+#endif
+    }
+
+    simd_t simd_level() {
+        static const simd_t level = _detect();
+        return level;
+    }
+
+}   /*! @} */
@@ -0,0 +1,47 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define XSCKT_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define XSCKT_TARGET(isa)
+#else
+#define XSCKT_TARGET(isa) __attribute__((target(isa)))     // compile one function for isa, call it only if simd_level() has it
+#endif
+#endif
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief simd_t - widest vector instructions the SIMD kernels may use on this CPU, each level includes those before it
+     */
+    enum class simd_t { SCALAR, SSE2, SSE42, AVX2 };
+
+    /**
+     * @brief simd_level - checked on first use, x86 only, elsewhere SCALAR
+     */
+    simd_t simd_level();
+
+#ifdef XSCKT_X86
+
+    /**
+     * @brief _first_bit - index of the lowest set bit of a non zero movemask
+     */
+    static inline unsigned int _first_bit(unsigned int mask) {
+#ifdef _MSC_VER
+        unsigned long bit;
+        _BitScanForward(&bit, mask);
+        return bit;
+#else
+        return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+    }
+
+#endif // XSCKT_X86
+
+}   /*! @} */
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+
 /**
  * \addtogroup xsckt
  * @{
@@ -12,6 +14,11 @@ namespace xsckt {
     enum class family_t { IPv4, IPv6, IrDA, Bluetooth };
     enum class socket_t { STREAM, DGRAM, RAW, RDM };
     enum class blocking_t { BLOCKING, NONBLOCKING};
+    enum class sharing_t { EXCLUSIVE, REUSEPORT };
+    enum class prefix_t { FIXED32, VARINT };    // message_framer length prefix, 4 byte big endian or LEB128
+
+    //zero copy send completion token, 0 for a send that needs no completion
+    using zero_copy_t = unsigned long long;
 
     //stop actions
     enum class action_t { READ, WRITE, READ_AND_WRITE };
@@ -20,6 +27,21 @@ namespace xsckt {
     static const std::string LOOPBACK_ADDR = { "127.0.0.1" };
     static const int DEFAULT_PORT = 5555;
     static const int DEFAULT_BUFFER_SIZE = 512;
+    static const int LARGE_BUFFER_SIZE = 65536;
     static const int BLUETOOTH_BACKLOG = 4;
+    static const int DEFAULT_MAX_EVENTS = 256;
+    static const unsigned int MAX_IO_VECTORS = 64;     // buffer views gathered by one write_v/read_v call
+    static const unsigned int MAX_BATCH_DATAGRAMS = 64; // datagrams moved by one read_batch/write_batch call
+    static const unsigned int MAX_OFFLOAD_SEGMENTS = 64;    // datagrams the kernel will cut one segment_offload write into
+    static const size_t ZERO_COPY_THRESHOLD = 32768;  // smaller writes are cheaper copied than pinned
+    static const size_t DEFAULT_MAX_MESSAGE = 16777216; // longest message a message_framer accepts
+    static const unsigned int DEFAULT_RING_ENTRIES = 1024;
+    static const unsigned int DEFAULT_RING_BUFFERS = 1024;
+    static const unsigned int DEFAULT_RING_BUFFER_SIZE = 4096;
+    static const std::chrono::milliseconds NO_TIMEOUT{ 0 };     // deadlines and idle timeouts left unset
+    static const std::chrono::milliseconds DEFAULT_IDLE_TIMEOUT{ 60000 };   // tcp_server closes a client silent for this long
+    static const size_t DEFAULT_HIGH_WATERMARK = 1048576;   // queued reply bytes at which tcp_server stops reading from a client
+    static const size_t DEFAULT_LOW_WATERMARK = 262144;     // and below which it starts again
+    static const size_t DEFAULT_POOL_SIZE = 8;  // idle connections a connection_pool keeps to each addr:port
 
 }   /*! @} */
@@ -12,101 +12,56 @@ namespace xsckt {
         bind_to(addr, port);
     }
 
-    std::string udp_server_socket::hostname() const {
-        return base_socket::hostname();
-    }
-
-    std::string udp_server_socket::read_from(const int flags) {
-        return  base_socket::read_from(flags);
-    }
-
-    long udp_server_socket::write_back(const std::string& buffer, const int flags) {
-        return base_socket::write_back(buffer, flags);
-    }
-
     //------------udp_client_socket implementation------------
     udp_client_socket::multi_socket(const std::string addr, const unsigned short port) :
         base_socket(AF_INET, SOCK_DGRAM, 0) {
         connect_to(addr, port);
     }
 
-    std::string udp_client_socket::hostname() const {
-        return base_socket::hostname();
-    }
-
-    std::string udp_client_socket::read(const int flags) const {
-        return base_socket::read(flags);
-    }
-
-    long udp_client_socket::write(const std::string& buffer, const int flags) const {
-        return  base_socket::write(buffer, flags);
-    }
-
     //------------tcp_active_socket implementation------------
     tcp_active_socket::multi_socket(unsigned int socket, blocking_t sync) :
-        base_socket(socket) 
-    {
-        if (sync == blocking_t::NONBLOCKING) {
-           base_socket::be_non_blocking();
-        }
-    }
-
-    std::string tcp_active_socket::hostname() const {
-        return base_socket::hostname();
-    }
+        base_socket(socket, sync)
+    {}
 
-    const size_t tcp_active_socket::peek() const {
-        return base_socket::peek();
-    }
-
-    std::string tcp_active_socket::read(const int flags) const {
-        return base_socket::read(flags);
-    }
-
-    long tcp_active_socket::write(const std::string& buffer, const int flags) const {
-        return  base_socket::write(buffer, flags);
+    tcp_active_socket::multi_socket(unsigned int socket, blocking_t sync, socket_tuner tune) :
+        base_socket(socket, sync)
+    {
+        tune(*this);
     }
 
     //------------tcp_server_socket implementation------------
-    tcp_server_socket::multi_socket(const std::string addr, const unsigned short port, blocking_t sync) :
-        base_socket(AF_INET, SOCK_STREAM, 0) 
+    tcp_server_socket::multi_socket(const std::string addr, const unsigned short port, blocking_t sync, sharing_t share) :
+        base_socket(AF_INET, SOCK_STREAM, 0, sync)
     {
-        if (sync == blocking_t::NONBLOCKING) {
-            base_socket::be_non_blocking();
+        if (share == sharing_t::REUSEPORT) {
+            base_socket::share_port();
         }
         bind_to(addr, port);
         listen_to();
     }
 
-    std::string tcp_server_socket::hostname() const {
-        return base_socket::hostname();
-    }
-
-    sockfd_t tcp_server_socket::accept_from() {
-        return base_socket::accept_from();
-    }
-  
-
-    void tcp_server_socket::stop(action_t action) {
-        base_socket::stop(action);
+    tcp_server_socket::multi_socket(const std::string addr, const unsigned short port, blocking_t sync, sharing_t share, socket_tuner tune, int backlog) :
+        base_socket(AF_INET, SOCK_STREAM, 0, sync)
+    {
+        if (share == sharing_t::REUSEPORT) {
+            base_socket::share_port();
+        }
+        tune(*this);    // buffer sizes and the like are inherited by accepted sockets, so before listening
+        bind_to(addr, port);
+        listen_to(backlog);
     }
 
     //------------tcp_client_socket implementation------------
-    tcp_client_socket::multi_socket(const std::string addr, const unsigned short port) :
-        base_socket(AF_INET, SOCK_STREAM, 0) {
-        connect_to(addr, port);
-    }
-
-    std::string tcp_client_socket::hostname() const {
-        return base_socket::hostname();
-    }
-
-    std::string tcp_client_socket::read(const int flags) const {
-        return base_socket::read(flags);
+    tcp_client_socket::multi_socket(const std::string addr, const unsigned short port, blocking_t sync, std::chrono::milliseconds timeout) :
+        base_socket(AF_INET, SOCK_STREAM, 0, sync) {
+        //a non-blocking connect does not wait anyway, its timeout is up to whoever waits for it
+        connect_to(addr, port, (sync == blocking_t::BLOCKING) ? timeout : NO_TIMEOUT);
     }
 
-    long tcp_client_socket::write(const std::string& buffer, const int flags) const {
-        return  base_socket::write(buffer, flags);
+    tcp_client_socket::multi_socket(const std::string addr, const unsigned short port, blocking_t sync, std::chrono::milliseconds timeout, socket_tuner tune) :
+        base_socket(AF_INET, SOCK_STREAM, 0, sync) {
+        tune(*this);    // the window scale is agreed in the handshake, so buffer sizes before connecting
+        connect_to(addr, port, (sync == blocking_t::BLOCKING) ? timeout : NO_TIMEOUT);
     }
 
-}   /*! @} */
\ No newline at end of file
+}   /*! @} */
@@ -20,16 +20,21 @@
 
 #endif
 
+#include "socket_options.h"
+
 /**
  * \addtogroup xsckt
  * @{
  */
 namespace xsckt {
 
-    //base factory template class
-    template<protocol_t, role_t, family_t, socket_t>
+    //base factory template class, options_type is a socket_options.h profile
+    template<protocol_t, role_t, family_t, socket_t, typename options_type = default_options>
     struct multi_socket {};
 
+    //applies an options profile to a new socket before it binds or connects
+    using socket_tuner = void (*)(base_socket&);
+
     //------------product definitions------------
     //udp sockets
     using udp_server_socket = multi_socket<protocol_t::UDP, role_t::server, family_t::IPv4, socket_t::DGRAM>;
@@ -38,7 +43,16 @@ namespace xsckt {
     using tcp_server_socket = multi_socket<protocol_t::TCP, role_t::server, family_t::IPv4, socket_t::STREAM>;
     using tcp_active_socket = multi_socket<protocol_t::TCP, role_t::active, family_t::IPv4, socket_t::STREAM>;
     using tcp_client_socket = multi_socket<protocol_t::TCP, role_t::client, family_t::IPv4, socket_t::STREAM>;
-
+    //tuned tcp sockets
+    using low_latency_tcp_server_socket = multi_socket<protocol_t::TCP, role_t::server, family_t::IPv4, socket_t::STREAM, low_latency_options>;
+    using low_latency_tcp_active_socket = multi_socket<protocol_t::TCP, role_t::active, family_t::IPv4, socket_t::STREAM, low_latency_options>;
+    using low_latency_tcp_client_socket = multi_socket<protocol_t::TCP, role_t::client, family_t::IPv4, socket_t::STREAM, low_latency_options>;
+    using bulk_tcp_server_socket = multi_socket<protocol_t::TCP, role_t::server, family_t::IPv4, socket_t::STREAM, bulk_options>;
+    using bulk_tcp_active_socket = multi_socket<protocol_t::TCP, role_t::active, family_t::IPv4, socket_t::STREAM, bulk_options>;
+    using bulk_tcp_client_socket = multi_socket<protocol_t::TCP, role_t::client, family_t::IPv4, socket_t::STREAM, bulk_options>;
+
+    //each product exposes the base_socket operations of its role with using declarations, so a call on one is a call
+    //straight to base_socket with no forwarder in between
     //------------udp_server_socket template------------
     template<>
     struct multi_socket<protocol_t::UDP, role_t::server, family_t::IPv4, socket_t::DGRAM> :
@@ -46,13 +60,18 @@ namespace xsckt {
 
         multi_socket(const std::string addr, const unsigned short port);
 
-        std::string hostname() const final;
+        using base_socket::hostname;
+        using base_socket::read_from;
+        using base_socket::write_back;
+        using base_socket::write_back_v;
+        using base_socket::read_from_v;
+        using base_socket::read_batch;
+        using base_socket::write_batch;
+        using base_socket::receive_offload;
+        using base_socket::read_from_segments;
+        using base_socket::handle;
 
-        std::string read_from(const int flags = 0) final;
-
-        long write_back(const std::string& buffer, const int flags = 0) final;
-
-        virtual ~multi_socket() override = default;
+        ~multi_socket() = default;
 
     };
 
@@ -63,13 +82,14 @@ namespace xsckt {
 
         multi_socket(const std::string addr, const unsigned short port);
 
-        std::string hostname() const final;
-
-        std::string read(const int flags = 0) const final;
+        using base_socket::hostname;
+        using base_socket::read;
+        using base_socket::write;
+        using base_socket::write_v;
+        using base_socket::read_v;
+        using base_socket::segment_offload;
 
-        long write(const std::string& buffer, const int flags = 0) const final;
-
-        virtual ~multi_socket() override = default;
+        ~multi_socket() = default;
 
     };
 
@@ -80,22 +100,35 @@ namespace xsckt {
 
         explicit multi_socket(unsigned int socket, blocking_t sync = blocking_t::BLOCKING);
 
-        multi_socket(const multi_socket&) = default;
-
-        multi_socket& operator= (const multi_socket&) = default;
+        multi_socket(multi_socket&&) = default;
 
-        std::string hostname() const final;
+        multi_socket& operator= (multi_socket&&) = default;
 
-        const size_t peek() const final;
+        multi_socket(const multi_socket&) = delete;
 
-        std::string read(const int flags = 0) const final;
+        multi_socket& operator= (const multi_socket&) = delete;
 
-        long write(const std::string& buffer, const int flags = 0) const final;
+        using base_socket::hostname;
+        using base_socket::peek;
+        using base_socket::read;
+        using base_socket::write;
+        using base_socket::write_v;
+        using base_socket::read_v;
+        using base_socket::stop;
+        using base_socket::deadline;
+        using base_socket::no_delay;
+        using base_socket::cork;
+        using base_socket::send_file;
+        using base_socket::zero_copy;
+        using base_socket::write_zero_copy;
+        using base_socket::is_sent;
+        using base_socket::handle;
 
-        virtual ~multi_socket() override = default;
+        ~multi_socket() = default;
 
-    private:
+    protected:
 
+        multi_socket(unsigned int socket, blocking_t sync, socket_tuner tune);
 
     };
 
@@ -104,15 +137,19 @@ namespace xsckt {
     struct multi_socket<protocol_t::TCP, role_t::server, family_t::IPv4, socket_t::STREAM> :
         private base_socket {
 
-        multi_socket(const std::string addr, const unsigned short port, blocking_t sync = blocking_t::BLOCKING);
+        multi_socket(const std::string addr, const unsigned short port, blocking_t sync = blocking_t::BLOCKING, sharing_t share = sharing_t::EXCLUSIVE);
+
+        using base_socket::hostname;
+        using base_socket::accept_from;
+        using base_socket::stop;
+        using base_socket::handle;
 
-        std::string hostname() const final;
+        ~multi_socket() = default;
 
-        virtual sockfd_t accept_from() final;
+    protected:
 
-        void stop(action_t action) final;
+        multi_socket(const std::string addr, const unsigned short port, blocking_t sync, sharing_t share, socket_tuner tune, int backlog);
 
-        virtual ~multi_socket() override = default;
     };
 
     //------------tcp_client_socket template------------
@@ -120,15 +157,59 @@ namespace xsckt {
     struct multi_socket<protocol_t::TCP, role_t::client, family_t::IPv4, socket_t::STREAM> :
         private base_socket {
 
-        multi_socket(const std::string addr, const unsigned short port);
+        multi_socket(const std::string addr, const unsigned short port, blocking_t sync = blocking_t::BLOCKING, std::chrono::milliseconds timeout = NO_TIMEOUT);
+
+        using base_socket::hostname;
+        using base_socket::read;
+        using base_socket::write;
+        using base_socket::write_v;
+        using base_socket::read_v;
+        using base_socket::stop;
+        using base_socket::deadline;
+        using base_socket::no_delay;
+        using base_socket::cork;
+        using base_socket::send_file;
+        using base_socket::zero_copy;
+        using base_socket::write_zero_copy;
+        using base_socket::is_sent;
+        using base_socket::handle;
 
-        std::string hostname() const final;
+        ~multi_socket() = default;
 
-        std::string read(const int flags = 0) const final;
+    protected:
+
+        multi_socket(const std::string addr, const unsigned short port, blocking_t sync, std::chrono::milliseconds timeout, socket_tuner tune);
+
+    };
+
+    //tuned sockets add no state of their own, only set the socket up differently, so they are used wherever the plain one is
+    //------------tuned tcp_active_socket template------------
+    template<typename options_type>
+    struct multi_socket<protocol_t::TCP, role_t::active, family_t::IPv4, socket_t::STREAM, options_type> :
+        public tcp_active_socket {
+
+        explicit multi_socket(unsigned int socket, blocking_t sync = blocking_t::BLOCKING) :
+            tcp_active_socket(socket, sync, &apply_options<options_type, role_t::active, xsckt::base_socket>) {}
+
+    };
+
+    //------------tuned tcp_server_socket template------------
+    template<typename options_type>
+    struct multi_socket<protocol_t::TCP, role_t::server, family_t::IPv4, socket_t::STREAM, options_type> :
+        public tcp_server_socket {
+
+        multi_socket(const std::string addr, const unsigned short port, blocking_t sync = blocking_t::BLOCKING, sharing_t share = sharing_t::EXCLUSIVE) :
+            tcp_server_socket(addr, port, sync, share, &apply_options<options_type, role_t::server, xsckt::base_socket>, options_type::backlog) {}
+
+    };
 
-        long write(const std::string& buffer, const int flags = 0) const final;
+    //------------tuned tcp_client_socket template------------
+    template<typename options_type>
+    struct multi_socket<protocol_t::TCP, role_t::client, family_t::IPv4, socket_t::STREAM, options_type> :
+        public tcp_client_socket {
 
-        virtual ~multi_socket() override = default;
+        multi_socket(const std::string addr, const unsigned short port, blocking_t sync = blocking_t::BLOCKING, std::chrono::milliseconds timeout = NO_TIMEOUT) :
+            tcp_client_socket(addr, port, sync, timeout, &apply_options<options_type, role_t::client, xsckt::base_socket>) {}
 
     };
 
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "xsckt.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief default_options - the socket option profile every multi_socket gets unless it names another, i.e. what the kernel
+     * does by itself plus SO_REUSEADDR and a SOMAXCONN backlog.
+     * A profile is a struct of static constexpr members, the last template argument of a TCP multi_socket. Derive from one of
+     * these and override what differs, e.g. struct polled : low_latency_options { static constexpr int busy_poll = 50; };
+     * Each option is applied by its own if constexpr, so a profile costs only the setsockopt calls it asks for, made once at
+     * construction, and one a platform does not have fails to compile rather than to construct.
+     */
+    struct default_options {
+        static constexpr int receive_buffer = 0;    // SO_RCVBUF bytes, 0 leaves the kernel to autotune it
+        static constexpr int send_buffer = 0;       // SO_SNDBUF bytes, 0 leaves the kernel to autotune it
+        static constexpr bool no_delay = false;     // TCP_NODELAY, see base_socket::no_delay
+        static constexpr bool quick_ack = false;    // TCP_QUICKACK, ack straight away until the kernel falls back to delayed acks
+        static constexpr int busy_poll = 0;         // SO_BUSY_POLL microseconds to spin on the device queue for a blocking read
+        static constexpr int defer_accept = 0;      // TCP_DEFER_ACCEPT seconds, server only: accept once the first bytes arrive
+        static constexpr int fast_open = 0;         // TCP_FASTOPEN queue length, server only: data in the SYN saves a round trip
+        static constexpr int backlog = SOMAXCONN;   // listen queue, server only
+        static constexpr bool reuse_address = true; // SO_REUSEADDR, false clears it again
+    };
+
+    /**
+     * @brief low_latency_options - small request/response messages: no Nagle or delayed ack holding a reply back, and a
+     * returning client's request carried in its SYN.
+     * @note busy_poll is left 0 as raising it above net.core.busy_read needs CAP_NET_ADMIN
+     * @note fast_open also needs bit 2 of net.ipv4.tcp_fastopen set, without it the option is accepted and unused
+     */
+    struct low_latency_options : default_options {
+#ifdef TCP_QUICKACK
+        static constexpr bool quick_ack = true;
+#endif
+        static constexpr bool no_delay = true;
+        static constexpr int fast_open = 256;
+    };
+
+    /**
+     * @brief bulk_options - long transfers: large fixed buffers so a high bandwidth-delay path is not window limited, and
+     * connections accepted only once they have something to read.
+     * @note the kernel caps the buffers at net.core.rmem_max and wmem_max, and a fixed size turns off autotuning, so they are
+     * only worth having where those limits have been raised
+     */
+    struct bulk_options : default_options {
+        static constexpr int receive_buffer = 4194304;
+        static constexpr int send_buffer = 4194304;
+#ifdef TCP_DEFER_ACCEPT
+        static constexpr int defer_accept = 1;
+#endif
+    };
+
+    /**
+     * @brief apply_options - set up a socket as options_type asks, before it binds or connects
+     * @tparam role - which of the options apply: the server ones to a listening socket, quick_ack to connected ones
+     */
+    template<typename options_type, role_t role, typename socket_type>
+    void apply_options(socket_type& sckt) {
+        static_assert(options_type::receive_buffer >= 0 && options_type::send_buffer >= 0, "buffer sizes cannot be negative");
+        static_assert(options_type::busy_poll >= 0 && options_type::defer_accept >= 0 && options_type::fast_open >= 0,
+            "busy_poll, defer_accept and fast_open cannot be negative");
+        static_assert(options_type::backlog > 0, "backlog must be positive");
+
+        if constexpr (!options_type::reuse_address && role != role_t::active) {
+            sckt.set_option(SOL_SOCKET, SO_REUSEADDR, 0);
+        }
+        if constexpr (options_type::receive_buffer > 0) {
+            sckt.set_option(SOL_SOCKET, SO_RCVBUF, options_type::receive_buffer);
+        }
+        if constexpr (options_type::send_buffer > 0) {
+            sckt.set_option(SOL_SOCKET, SO_SNDBUF, options_type::send_buffer);
+        }
+        if constexpr (options_type::no_delay) {
+            sckt.set_option(IPPROTO_TCP, TCP_NODELAY, 1);
+        }
+        if constexpr (options_type::quick_ack && role != role_t::server) {
+#ifdef TCP_QUICKACK
+            sckt.set_option(IPPROTO_TCP, TCP_QUICKACK, 1);
+#else
+            static_assert(!options_type::quick_ack, "TCP_QUICKACK is not supported on this platform");
+#endif
+        }
+        if constexpr (options_type::busy_poll > 0) {
+#ifdef SO_BUSY_POLL
+            sckt.set_option(SOL_SOCKET, SO_BUSY_POLL, options_type::busy_poll);
+#else
+            static_assert(options_type::busy_poll == 0, "SO_BUSY_POLL is not supported on this platform");
+#endif
+        }
+        if constexpr (options_type::defer_accept > 0 && role == role_t::server) {
+#ifdef TCP_DEFER_ACCEPT
+            sckt.set_option(IPPROTO_TCP, TCP_DEFER_ACCEPT, options_type::defer_accept);
+#else
+            static_assert(options_type::defer_accept == 0, "TCP_DEFER_ACCEPT is not supported on this platform");
+#endif
+        }
+        if constexpr (options_type::fast_open > 0 && role == role_t::server) {
+#ifdef TCP_FASTOPEN
+            sckt.set_option(IPPROTO_TCP, TCP_FASTOPEN, options_type::fast_open);
+#else
+            static_assert(options_type::fast_open == 0, "TCP_FASTOPEN is not supported on this platform");
+#endif
+        }
+    }
+
+}   /*! @} */
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "xsckt.h"
+#include "byte_scan.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief The stream_reader class serves delimited and fixed size reads from large reads of any connected stream multi_socket.
+     * @version 0.1
+     * Each read from the socket takes all the buffer has room for, so a burst of pipelined lines costs one recv rather than
+     * one each. Delimiters are found with find_byte, and a search that runs out of data carries on from where it stopped
+     * rather than rescanning when more arrives.
+     * With a non-blocking socket each call returns -1 with would_block() true until the whole item has arrived, keeping
+     * what has been read so far, so it can be called again on the next readable event.
+     * @note a returned view is valid until the next call
+     * @note not thread safe - one stream_reader per connection, and the socket must outlive it
+     */
+    template<XSCKT_STREAM_SOCKET socket_type>
+    class stream_reader {
+
+    public:
+
+        /**
+         * @brief stream_reader
+         * @param sckt - socket with read(char*, size_t, flags)
+         * @param capacity - initial buffer size, it grows for a longer item up to max_size
+         * @param max_size - longest item read_until/read_exact will buffer, beyond it they throw
+         */
+        explicit stream_reader(socket_type& sckt, size_t capacity = LARGE_BUFFER_SIZE, size_t max_size = DEFAULT_MAX_MESSAGE) :
+            _sckt(sckt), _buffer(capacity), _max_size(max_size) {}
+
+        /**
+         * @brief read_until - everything up to and including the next delim
+         * @param out - set to the bytes, delim included; at the end of the stream whatever is left, which may not end in delim
+         * @return long - bytes in out, 0 at the end of the stream with nothing left, -1 with would_block() true if delim has not arrived yet
+         */
+        long read_until(char delim, const_buffer& out) {
+            if (delim != _delim) {
+                _delim = delim;
+                _scanned = _begin;
+            }
+            while (true) {
+                auto found = find_byte(_buffer.data() + _scanned, _end - _scanned, delim);
+                if (found) {
+                    return _take(static_cast<size_t>(found - _buffer.data()) + 1 - _begin, out);
+                }
+                _scanned = _end;
+                auto i = _fill();
+                if (i <= 0) {
+                    return (i == 0 && _end > _begin) ? _take(_end - _begin, out) : i;
+                }
+            }
+        }
+
+        /**
+         * @brief read_exact - the next n bytes
+         * @param out - set to the bytes
+         * @return long - n, 0 if the stream ended first, -1 with would_block() true if they have not all arrived yet
+         */
+        long read_exact(size_t n, const_buffer& out) {
+            if (n > _max_size) {
+                throw std::runtime_error("stream_reader: read_exact longer than max_size");
+            }
+            while (_end - _begin < n) {
+                auto i = _fill(n - (_end - _begin));
+                if (i <= 0) {
+                    return i;
+                }
+            }
+            return _take(n, out);
+        }
+
+        /**
+         * @brief read_line - the next line, with its \n or \r\n stripped
+         * @param out - set to the line
+         * @return long - bytes consumed, terminator included so an empty line is still positive, otherwise as read_until
+         */
+        long read_line(const_buffer& out) {
+            auto i = read_until('\n', out);
+            if (i > 0 && out.size > 0 && out.data[out.size - 1] == '\n') {
+                --out.size;
+                if (out.size > 0 && out.data[out.size - 1] == '\r') {
+                    --out.size;
+                }
+            }
+            return i;
+        }
+
+        /**
+         * @brief buffered - bytes read from the socket but not yet returned
+         */
+        size_t buffered() const {
+            return _end - _begin;
+        }
+
+    private:
+
+        long _take(size_t n, const_buffer& out) {
+            out = { _buffer.data() + _begin, n };
+            _begin += n;
+            _scanned = _begin;
+            return static_cast<long>(n);
+        }
+
+        /**
+         * @brief _fill - one read into the free space, first making room for at least want bytes more
+         */
+        long _fill(size_t want = 1) {
+            if (_buffer.size() - _end < want) {
+                //slide what is still wanted to the front, then grow only if that is not enough
+                auto scanned = _scanned - _begin;
+                std::memmove(_buffer.data(), _buffer.data() + _begin, _end - _begin);
+                _end -= _begin;
+                _begin = 0;
+                _scanned = scanned;
+                if (_buffer.size() - _end < want) {
+                    if (_end >= _max_size) {
+                        throw std::runtime_error("stream_reader: item longer than max_size");
+                    }
+                    _buffer.resize(std::max(_buffer.size() * 2, _end + want));
+                }
+            }
+            auto i = _sckt.read(_buffer.data() + _end, _buffer.size() - _end);
+            if (i > 0) {
+                _end += static_cast<size_t>(i);
+            }
+            return i;
+        }
+
+        socket_type& _sckt;
+        std::vector<char> _buffer;
+        size_t _max_size;
+        size_t _begin{ 0 };     // first byte not yet returned
+        size_t _end{ 0 };       // one past the last byte read
+        size_t _scanned{ 0 };   // read_until has searched up to here
+        char _delim{ '\n' };    // for this delimiter
+
+    };
+
+}   /*! @} */
@@ -0,0 +1,193 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    timer_wheel::timer_wheel(std::chrono::milliseconds tick) :
+        _tick(std::max(tick, std::chrono::milliseconds(1))),
+        _start(clock::now()),
+        _nodes(SLOTS + 1)
+    {
+        for (unsigned int i = 0; i <= SLOTS; ++i) {
+            _nodes[i].prev = _nodes[i].next = i;
+        }
+    }
+
+    unsigned long long timer_wheel::_when(std::chrono::milliseconds delay) const {
+        //counted from the real time rather than the last expire, which may have been a while ago
+        auto now = std::max(static_cast<unsigned long long>((clock::now() - _start) / _tick), _current);
+        //rounded up, and the tick in progress does not count, so a timer never fires early
+        auto ticks = (delay.count() <= 0) ? 0 : static_cast<unsigned long long>((delay.count() + _tick.count() - 1) / _tick.count());
+        return std::min(now + ticks + 1, _current + MAX_DELAY);
+    }
+
+    unsigned int timer_wheel::_slot(unsigned long long when) const {
+        auto delta = when - _current;
+        if (delta < ROOT_SLOTS) {
+            return static_cast<unsigned int>(when & (ROOT_SLOTS - 1));
+        }
+        unsigned int level = 1;
+        auto shift = ROOT_BITS;
+        while (level < LEVELS - 1 && delta >= (1ULL << (shift + LEVEL_BITS))) {
+            ++level;
+            shift += LEVEL_BITS;
+        }
+        return ROOT_SLOTS + (level - 1) * LEVEL_SLOTS + static_cast<unsigned int>((when >> shift) & (LEVEL_SLOTS - 1));
+    }
+
+    void timer_wheel::_link(unsigned int slot, unsigned int i) {
+        auto& sentinel = _nodes[slot];
+        _nodes[i].prev = sentinel.prev;
+        _nodes[i].next = slot;
+        _nodes[sentinel.prev].next = i;
+        sentinel.prev = i;
+    }
+
+    void timer_wheel::_unlink(unsigned int i) {
+        auto& node = _nodes[i];
+        _nodes[node.prev].next = node.next;
+        _nodes[node.next].prev = node.prev;
+        node.prev = node.next = i;
+    }
+
+    void timer_wheel::_release(unsigned int i) {
+        auto& node = _nodes[i];
+        node.on_expiry = nullptr;
+        if (++node.generation == 0) {
+            node.generation = 1;
+        }
+        node.next = _free;
+        _free = i;
+        --_armed;
+    }
+
+    timer_handle timer_wheel::arm(std::chrono::milliseconds delay, callback_t on_expiry) {
+        unsigned int i;
+        if (_free != NONE) {
+            i = _free;
+            _free = _nodes[i].next;
+        }
+        else {
+            i = static_cast<unsigned int>(_nodes.size());
+            _nodes.emplace_back();
+        }
+        auto& node = _nodes[i];
+        node.when = _when(delay);
+        node.on_expiry = std::move(on_expiry);
+        _link(_slot(node.when), i);
+        ++_armed;
+        return { i, node.generation };
+    }
+
+    bool timer_wheel::rearm(timer_handle handle, std::chrono::milliseconds delay) {
+        if (!handle || handle.index >= _nodes.size() || _nodes[handle.index].generation != handle.generation) {
+            return false;
+        }
+        _unlink(handle.index);
+        _nodes[handle.index].when = _when(delay);
+        _link(_slot(_nodes[handle.index].when), handle.index);
+        return true;
+    }
+
+    bool timer_wheel::cancel(timer_handle& handle) {
+        auto armed = handle && handle.index < _nodes.size() && _nodes[handle.index].generation == handle.generation;
+        if (armed) {
+            _unlink(handle.index);
+            _release(handle.index);
+        }
+        handle = timer_handle();
+        return armed;
+    }
+
+    void timer_wheel::_cascade(unsigned int slot) {
+        //relinked by what is left of their delay, which always lands them below the level they came from
+        while (_nodes[slot].next != slot) {
+            auto i = _nodes[slot].next;
+            _unlink(i);
+            _link(_slot(_nodes[i].when), i);
+        }
+    }
+
+    size_t timer_wheel::_fire(unsigned int slot) {
+        if (_nodes[slot].next == slot) {
+            return 0;
+        }
+        //moved to the firing list first, so callbacks are free to arm and cancel timers, these included
+        auto& firing = _nodes[FIRING];
+        auto& sentinel = _nodes[slot];
+        firing.next = sentinel.next;
+        firing.prev = sentinel.prev;
+        _nodes[firing.next].prev = FIRING;
+        _nodes[firing.prev].next = FIRING;
+        sentinel.prev = sentinel.next = slot;
+        size_t fired = 0;
+        while (_nodes[FIRING].next != FIRING) {
+            auto i = _nodes[FIRING].next;
+            _unlink(i);
+            auto on_expiry = std::move(_nodes[i].on_expiry);
+            _release(i);
+            ++fired;
+            on_expiry();
+        }
+        return fired;
+    }
+
+    size_t timer_wheel::expire(clock::time_point now) {
+        if (now < _start) {
+            return 0;
+        }
+        auto target = static_cast<unsigned long long>((now - _start) / _tick);
+        size_t fired = 0;
+        while (_current < target) {
+            if (_armed == 0) {
+                _current = target;   //nothing to move or fire, skip straight there
+                break;
+            }
+            ++_current;
+            if ((_current & (ROOT_SLOTS - 1)) == 0) {
+                //the lowest level has wrapped, bring down the next slot of each level whose span has also rolled over
+                auto shift = ROOT_BITS;
+                unsigned int level = 1;
+                while (level < LEVELS - 1 && (_current & ((1ULL << (shift + LEVEL_BITS)) - 1)) == 0) {
+                    ++level;
+                    shift += LEVEL_BITS;
+                }
+                for (; level > 0; --level, shift -= LEVEL_BITS) {
+                    _cascade(ROOT_SLOTS + (level - 1) * LEVEL_SLOTS + static_cast<unsigned int>((_current >> shift) & (LEVEL_SLOTS - 1)));
+                }
+            }
+            fired += _fire(static_cast<unsigned int>(_current & (ROOT_SLOTS - 1)));
+        }
+        return fired;
+    }
+
+    int timer_wheel::next_timeout(clock::time_point now) const {
+        if (_armed == 0) {
+            return -1;
+        }
+        //the first non-empty slot of the lowest level, or the next wrap, when a cascade may bring timers down
+        auto tick = _current + 1;
+        for (; (tick & (ROOT_SLOTS - 1)) != 0; ++tick) {
+            auto slot = static_cast<unsigned int>(tick & (ROOT_SLOTS - 1));
+            if (_nodes[slot].next != slot) {
+                break;
+            }
+        }
+        auto due = _start + _tick * static_cast<long long>(tick);
+        if (due <= now) {
+            return 0;
+        }
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(due - now).count();
+        return static_cast<int>(std::min<long long>(ms + 1, (1LL << 31) - 1));
+    }
+
+    size_t timer_wheel::size() const {
+        return _armed;
+    }
+
+}   /*! @} */
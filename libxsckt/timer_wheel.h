@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief timer_handle - names an armed timer, a default constructed handle names none
+     */
+    struct timer_handle {
+        unsigned int index{ 0 };
+        unsigned int generation{ 0 };     // 0 for no timer, a stale handle fails the generation check
+
+        explicit operator bool() const {
+            return generation != 0;
+        }
+    };
+
+    /**
+     * @brief The timer_wheel class is a hierarchical timing wheel for idle timeouts and I/O deadlines.
+     * @version 0.1
+     * Four levels of slots: 256 one tick slots, then three levels of 64 each covering 64 times the span of the level
+     * below. Arming links the timer into the slot for its expiry, cancelling unlinks it, both O(1) and without allocating
+     * once the timer storage has grown to the number armed at once. Each time the lowest level wraps, the next slot up is
+     * cascaded down into the finer levels, so every timer is moved at most three times before it fires.
+     * Expiry is to the tick, never early: a timer armed for d fires on the first expire call at least d later, rounded up
+     * to a whole tick.
+     * @note delays beyond 2^26 ticks (18.6 hours at 1ms) are capped to it
+     * @note not thread safe - one timer_wheel per thread, callbacks run on the thread calling expire
+     */
+    class timer_wheel {
+
+    public:
+
+        using callback_t = std::function<void()>;
+        using clock = std::chrono::steady_clock;
+
+        static const unsigned int ROOT_BITS = 8;
+        static const unsigned int LEVEL_BITS = 6;
+        static const unsigned int LEVELS = 4;
+
+        /**
+         * @brief timer_wheel
+         * @param tick - resolution, delays are rounded up to a multiple of it
+         */
+        explicit timer_wheel(std::chrono::milliseconds tick = std::chrono::milliseconds(1));
+
+        timer_wheel(const timer_wheel&) = delete;
+
+        timer_wheel& operator= (const timer_wheel&) = delete;
+
+        /**
+         * @brief arm - call on_expiry once delay has passed
+         * @return timer_handle - to cancel or rearm it, it goes stale once the timer has fired
+         */
+        timer_handle arm(std::chrono::milliseconds delay, callback_t on_expiry);
+
+        /**
+         * @brief rearm - push an armed timer back to delay from now, keeping its callback
+         * @return bool - false if the timer has already fired or been cancelled
+         */
+        bool rearm(timer_handle handle, std::chrono::milliseconds delay);
+
+        /**
+         * @brief cancel - disarm a timer, safe to call from inside any callback and with a stale or empty handle
+         * @param handle - reset to name no timer
+         * @return bool - false if the timer had already fired or been cancelled
+         */
+        bool cancel(timer_handle& handle);
+
+        /**
+         * @brief expire - fire every timer due by now, in expiry order
+         * @return size_t - number fired
+         */
+        size_t expire(clock::time_point now = clock::now());
+
+        /**
+         * @brief next_timeout - milliseconds the caller may sleep before calling expire again
+         * @return int - 0 if a timer is already due, -1 if none are armed
+         * @note may be earlier than the next expiry when that lies beyond the current turn of the lowest level
+         */
+        int next_timeout(clock::time_point now = clock::now()) const;
+
+        /**
+         * @brief size - number of timers armed
+         */
+        size_t size() const;
+
+    private:
+
+        static const unsigned int ROOT_SLOTS = 1 << ROOT_BITS;
+        static const unsigned int LEVEL_SLOTS = 1 << LEVEL_BITS;
+        static const unsigned int SLOTS = ROOT_SLOTS + (LEVELS - 1) * LEVEL_SLOTS;
+        static const unsigned int FIRING = SLOTS;   // sentinel of the list of timers due this tick
+        static const unsigned long long MAX_DELAY = (1ULL << (ROOT_BITS + (LEVELS - 1) * LEVEL_BITS)) - 1;
+        static const unsigned int NONE = ~0U;
+
+        /**
+         * @brief node_t - a timer, or the sentinel of a slot's circular list
+         */
+        struct node_t {
+            unsigned int prev;
+            unsigned int next;
+            unsigned int generation{ 1 };
+            unsigned long long when{ 0 };   // tick to fire on
+            callback_t on_expiry;
+        };
+
+        unsigned long long _when(std::chrono::milliseconds delay) const;
+        unsigned int _slot(unsigned long long when) const;
+        void _link(unsigned int slot, unsigned int i);
+        void _unlink(unsigned int i);
+        void _release(unsigned int i);
+        void _cascade(unsigned int slot);
+        size_t _fire(unsigned int slot);
+
+        std::chrono::milliseconds _tick;
+        clock::time_point _start;
+        unsigned long long _current{ 0 };   // last tick processed by expire
+        size_t _armed{ 0 };
+        unsigned int _free{ NONE };         // released timers, chained through next
+        std::vector<node_t> _nodes;         // the slot sentinels and firing list first, then the timers
+
+    };
+
+}   /*! @} */
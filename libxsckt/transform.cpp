@@ -0,0 +1,203 @@
+#include "transform.h"
+
+#include <cstring>
+#include <cstdint>
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /*
+     * Case conversion flips bit 0x20 of the 26 letters starting at first. The vector kernels move that range to the
+     * bottom of the signed byte range with one add, so a single signed compare finds the letters in 16 or 32 bytes.
+     */
+
+    static void _flip_case_scalar(char* data, size_t size, char first) {
+        for (size_t i = 0; i < size; ++i) {
+            if (static_cast<unsigned char>(data[i] - first) < 26) {
+                data[i] ^= 0x20;
+            }
+        }
+    }
+
+#ifdef XSCKT_X86
+
+    XSCKT_TARGET("sse2")
+    static void _flip_case_sse2(char* data, size_t size, char first) {
+        auto shift = _mm_set1_epi8(static_cast<char>(0x80 - first));
+        auto limit = _mm_set1_epi8(static_cast<char>(-128 + 26));
+        auto bit = _mm_set1_epi8(0x20);
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16) {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            auto letters = _mm_cmpgt_epi8(limit, _mm_add_epi8(block, shift));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), _mm_xor_si128(block, _mm_and_si128(letters, bit)));
+        }
+        _flip_case_scalar(data + i, size - i, first);
+    }
+
+    XSCKT_TARGET("avx2")
+    static void _flip_case_avx2(char* data, size_t size, char first) {
+        auto shift = _mm256_set1_epi8(static_cast<char>(0x80 - first));
+        auto limit = _mm256_set1_epi8(static_cast<char>(-128 + 26));
+        auto bit = _mm256_set1_epi8(0x20);
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            auto letters = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(block, shift));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), _mm256_xor_si256(block, _mm256_and_si256(letters, bit)));
+        }
+        _flip_case_sse2(data + i, size - i, first);
+    }
+
+    XSCKT_TARGET("sse4.2")
+    static unsigned int _crc32c_sse42(unsigned int crc, const char* data, size_t size) {
+        size_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+        unsigned long long crc64 = crc;
+        for (; i + 8 <= size; i += 8) {
+            unsigned long long word;
+            std::memcpy(&word, data + i, 8);
+            crc64 = _mm_crc32_u64(crc64, word);
+        }
+        crc = static_cast<unsigned int>(crc64);
+#else
+        for (; i + 4 <= size; i += 4) {
+            unsigned int word;
+            std::memcpy(&word, data + i, 4);
+            crc = _mm_crc32_u32(crc, word);
+        }
+#endif
+        for (; i < size; ++i) {
+            crc = _mm_crc32_u8(crc, static_cast<unsigned char>(data[i]));
+        }
+        return crc;
+    }
+
+#endif // XSCKT_X86
+
+    using flip_case_t = void (*)(char*, size_t, char);
+
+    static flip_case_t _select_flip_case() {
+#ifdef XSCKT_X86
+        switch (simd_level()) {
+        case simd_t::AVX2:
+            return _flip_case_avx2;
+        case simd_t::SSE42:
+        case simd_t::SSE2:
+            return _flip_case_sse2;
+        default:
+            break;
+        }
+#endif
+        return _flip_case_scalar;
+    }
+
+    static void _flip_case(char* data, size_t size, char first) {
+        //resolved on first use rather than at static initialisation, as find_byte
+        static const flip_case_t flip = _select_flip_case();
+        flip(data, size, first);
+    }
+
+    void ascii_upper(char* data, size_t size) {
+        _flip_case(data, size, 'a');
+    }
+
+    void ascii_lower(char* data, size_t size) {
+        _flip_case(data, size, 'A');
+    }
+
+    void map_bytes(char* data, size_t size, const unsigned char* table) {
+        //a table lookup a byte - gathers do not beat it below AVX-512 VBMI, so unroll to keep the loads independent
+        auto p = reinterpret_cast<unsigned char*>(data);
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4) {
+            auto a = table[p[i]];
+            auto b = table[p[i + 1]];
+            auto c = table[p[i + 2]];
+            auto d = table[p[i + 3]];
+            p[i] = a;
+            p[i + 1] = b;
+            p[i + 2] = c;
+            p[i + 3] = d;
+        }
+        for (; i < size; ++i) {
+            p[i] = table[p[i]];
+        }
+    }
+
+    static unsigned int _crc32c_scalar(unsigned int crc, const char* data, size_t size) {
+        static const auto table = [] {
+            std::array<unsigned int, 256> t{};
+            for (unsigned int n = 0; n < 256; ++n) {
+                auto c = n;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : c >> 1;     // the reflected Castagnoli polynomial
+                }
+                t[n] = c;
+            }
+            return t;
+        }();
+        for (size_t i = 0; i < size; ++i) {
+            crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+    using crc32c_t = unsigned int (*)(unsigned int, const char*, size_t);
+
+    static crc32c_t _select_crc32c() {
+#ifdef XSCKT_X86
+        if (simd_level() >= simd_t::SSE42) {
+            return _crc32c_sse42;
+        }
+#endif
+        return _crc32c_scalar;
+    }
+
+    unsigned int crc32c(unsigned int crc, const char* data, size_t size) {
+        static const crc32c_t checksum = _select_crc32c();
+        return ~checksum(~crc, data, size);
+    }
+
+    void upper_case_stage::apply(char* data, size_t size) const {
+        ascii_upper(data, size);
+    }
+
+    void lower_case_stage::apply(char* data, size_t size) const {
+        ascii_lower(data, size);
+    }
+
+    byte_map_stage::byte_map_stage() {
+        for (size_t i = 0; i < _table.size(); ++i) {
+            _table[i] = static_cast<unsigned char>(i);
+        }
+    }
+
+    byte_map_stage::byte_map_stage(const std::array<unsigned char, 256>& table) :
+        _table(table)
+    {
+    }
+
+    void byte_map_stage::map(unsigned char from, unsigned char to) {
+        _table[from] = to;
+    }
+
+    void byte_map_stage::apply(char* data, size_t size) const {
+        map_bytes(data, size, _table.data());
+    }
+
+    transform_pipeline& transform_pipeline::add(std::shared_ptr<const transform_stage> stage) {
+        _stages.push_back(std::move(stage));
+        return *this;
+    }
+
+    void transform_pipeline::apply(char* data, size_t size) const {
+        for (auto& stage : _stages) {
+            stage->apply(data, size);
+        }
+    }
+
+}   /*! @} */
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "simd.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief ascii_upper - a-z to A-Z in place, every other byte left as it is whatever the locale
+     */
+    void ascii_upper(char* data, size_t size);
+
+    /**
+     * @brief ascii_lower - A-Z to a-z in place, every other byte left as it is whatever the locale
+     */
+    void ascii_lower(char* data, size_t size);
+
+    /**
+     * @brief map_bytes - replace every byte b with table[b] in place
+     */
+    void map_bytes(char* data, size_t size, const unsigned char* table);
+
+    /**
+     * @brief crc32c - CRC-32C (Castagnoli) of data, 8 bytes an instruction on SSE4.2 CPUs
+     * @param crc - 0 to start, or the crc32c of the preceding bytes to carry on over a message that arrived in pieces
+     */
+    unsigned int crc32c(unsigned int crc, const char* data, size_t size);
+
+    /**
+     * @brief The transform_stage class is one in place step a server handler applies to each payload before it is sent back.
+     * @version 0.1
+     * @note apply is const and may be called from several client threads at once
+     */
+    class transform_stage {
+
+    public:
+
+        virtual ~transform_stage() = default;
+
+        /**
+         * @brief apply - rewrite size bytes of data in place
+         */
+        virtual void apply(char* data, size_t size) const = 0;
+
+    };
+
+    class upper_case_stage final : public transform_stage {
+
+    public:
+
+        void apply(char* data, size_t size) const final;
+
+    };
+
+    class lower_case_stage final : public transform_stage {
+
+    public:
+
+        void apply(char* data, size_t size) const final;
+
+    };
+
+    /**
+     * @brief The byte_map_stage class substitutes every byte through a 256 entry table, e.g. ROT13 or a code page.
+     */
+    class byte_map_stage final : public transform_stage {
+
+    public:
+
+        /**
+         * @brief byte_map_stage - starts as the identity map
+         */
+        byte_map_stage();
+
+        explicit byte_map_stage(const std::array<unsigned char, 256>& table);
+
+        /**
+         * @brief map - send from to to
+         */
+        void map(unsigned char from, unsigned char to);
+
+        void apply(char* data, size_t size) const final;
+
+    private:
+
+        std::array<unsigned char, 256> _table;
+
+    };
+
+    /**
+     * @brief The transform_pipeline class applies its stages in the order they were added.
+     */
+    class transform_pipeline final : public transform_stage {
+
+    public:
+
+        transform_pipeline& add(std::shared_ptr<const transform_stage> stage);
+
+        void apply(char* data, size_t size) const final;
+
+    private:
+
+        std::vector<std::shared_ptr<const transform_stage>> _stages;
+
+    };
+
+}   /*! @} */
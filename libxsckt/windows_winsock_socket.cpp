@@ -1,6 +1,7 @@
 #ifdef WIN32
 
 #include "windows_winsock_socket.h"
+#include "metrics.h"
 
 #include <cassert>
 #include <stdexcept>
@@ -13,10 +14,44 @@
  */
 namespace xsckt {
 
-	base_socket::base_socket(const sockfd_t socket) :
+    using io_vectors_t = std::array<WSABUF, MAX_IO_VECTORS>;
+
+    /**
+     * @brief _gather - copy up to MAX_IO_VECTORS buffer views into the WSABUF array WSASend/WSARecv take
+     * @return DWORD - number of WSABUFs filled
+     */
+    template<typename buffer_type>
+    static DWORD _gather(const buffer_type* buffers, size_t count, io_vectors_t& iov) {
+        auto n = (count < iov.size()) ? count : iov.size();
+        for (size_t i = 0; i < n; ++i) {
+            iov[i].buf = const_cast<char*>(buffers[i].data);
+            iov[i].len = static_cast<ULONG>(buffers[i].size);
+        }
+        return static_cast<DWORD>(n);
+    }
+
+    /**
+     * @brief _meter - count a read or write syscall that returned i, before anything else can change the last error
+     */
+    static void _meter(direction_t direction, long i) {
+#ifndef XSCKT_NO_METRICS
+        metrics::io(direction, i, i == SOCKET_ERROR && would_block());
+#endif
+    }
+
+    /**
+     * @brief _meter_call - count any other syscall that returned i
+     */
+    static void _meter_call(long i) {
+#ifndef XSCKT_NO_METRICS
+        metrics::call(i, i == SOCKET_ERROR && would_block());
+#endif
+    }
+
+	base_socket::base_socket(const sockfd_t socket, blocking_t sync) :
         _long_addr(nullptr),
-        _hints(addrinfo{ 0 }),
-        _raddr(sockaddr_in{ 0 })
+        _hints{},
+        _raddr{}
     {
         assert(_socket > 0);
         _socket = socket;
@@ -28,9 +63,12 @@ namespace xsckt {
             sizeof(int)) == SOCKET_ERROR) {
                 throw std::runtime_error(make_error_message());
         }
+        if (sync == blocking_t::NONBLOCKING) {
+            be_non_blocking();
+        }
     }
 
-    base_socket::base_socket(const short address_family, const int socket_type, const int protocol) :
+    base_socket::base_socket(const short address_family, const int socket_type, const int protocol, blocking_t sync) :
         _address_family(address_family),
         _socket_type(socket_type),
         _protocol(protocol)
@@ -54,11 +92,56 @@ namespace xsckt {
                 throw std::runtime_error(make_error_message());
         }
         assert(_socket > 0);
+        if (sync == blocking_t::NONBLOCKING) {
+            be_non_blocking();
+        }
+    }
+
+    base_socket::base_socket(base_socket&& other) noexcept :
+        _socket(other._socket),
+        _address_family(other._address_family),
+        _socket_type(other._socket_type),
+        _protocol(other._protocol),
+        _long_addr(other._long_addr),
+        _hints(other._hints),
+        _raddr(other._raddr),
+        _zero_copy_threshold(other._zero_copy_threshold),
+        _zero_copy_sent(other._zero_copy_sent),
+        _zero_copy_completed(other._zero_copy_completed),
+        _non_blocking(other._non_blocking)
+    {
+        other._socket = INVALID_SOCKET;
+        other._long_addr = nullptr;
+    }
+
+    base_socket& base_socket::operator= (base_socket&& other) noexcept {
+        if (this != &other) {
+            if (_socket != INVALID_SOCKET) {
+                shutdown(_socket, SD_BOTH);
+                closesocket(_socket);
+            }
+            _socket = other._socket;
+            _address_family = other._address_family;
+            _socket_type = other._socket_type;
+            _protocol = other._protocol;
+            _long_addr = other._long_addr;
+            _hints = other._hints;
+            _raddr = other._raddr;
+            _zero_copy_threshold = other._zero_copy_threshold;
+            _zero_copy_sent = other._zero_copy_sent;
+            _zero_copy_completed = other._zero_copy_completed;
+            _non_blocking = other._non_blocking;
+            other._socket = INVALID_SOCKET;
+            other._long_addr = nullptr;
+        }
+        return *this;
     }
 
     base_socket::~base_socket() {
-        shutdown(_socket, SD_BOTH);
-        closesocket(_socket);
+        if (_socket != INVALID_SOCKET) {    // moved from
+            shutdown(_socket, SD_BOTH);
+            closesocket(_socket);
+        }
     }
 
     void base_socket::bind_to(address_t& address, port_t port) {
@@ -80,6 +163,12 @@ namespace xsckt {
         }
     }
 
+    void base_socket::listen_to(int backlog) {
+        if (listen(_socket, backlog) < 0) {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
     bool base_socket::is_listening() const {
         char val;
         int len = sizeof(val);
@@ -99,16 +188,88 @@ namespace xsckt {
         auto s = accept(_socket, //this bound and listening socket's file descriptor
             reinterpret_cast<struct sockaddr*>(&_raddr), //filled in with the remote address of this peer socket
             &len_raddr);
+        _meter_call((s == INVALID_SOCKET) ? SOCKET_ERROR : 0);
         if (s == INVALID_SOCKET) {
             throw std::runtime_error(make_error_message());
         }
+        metrics::count(counter_t::ACCEPTS);
         return s; //the newly created socket using the connected file descriptor
     }
 
     void base_socket::connect_to(address_t& address, port_t port) {
-        if (connect(_socket, _long_addr->ai_addr, _long_addr->ai_addrlen) == SOCKET_ERROR) {
+        auto e = _getaddrinfo(address, port);
+        if (e != 0) {
+            throw std::runtime_error(make_error_message());
+        }
+        auto i = connect(_socket, _long_addr->ai_addr, static_cast<int>(_long_addr->ai_addrlen));
+        freeaddrinfo(_long_addr);
+        _long_addr = nullptr;
+        if (i == SOCKET_ERROR && !would_block()) { //a non-blocking connect completes in the background
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    void base_socket::connect_to(address_t& address, port_t port, std::chrono::milliseconds timeout) {
+        if (timeout <= NO_TIMEOUT) {
+            connect_to(address, port);
+            return;
+        }
+        auto e = _getaddrinfo(address, port);
+        if (e != 0) {
+            throw std::runtime_error(make_error_message());
+        }
+        auto blocking = !_non_blocking;
+        if (blocking) {
+            be_non_blocking();
+        }
+        auto i = connect(_socket, _long_addr->ai_addr, static_cast<int>(_long_addr->ai_addrlen));
+        freeaddrinfo(_long_addr);
+        _long_addr = nullptr;
+        if (i == SOCKET_ERROR && !would_block()) {
+            throw std::runtime_error(make_error_message());
+        }
+        WSAPOLLFD p = { _socket, POLLWRNORM, 0 };
+        i = WSAPoll(&p, 1, static_cast<INT>(timeout.count()));
+        if (i == SOCKET_ERROR) {
             throw std::runtime_error(make_error_message());
         }
+        if (i == 0) {
+            throw std::runtime_error("connect to " + address + " timed out");
+        }
+        int error = 0;
+        int len = sizeof(error);
+        if (getsockopt(_socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &len) == SOCKET_ERROR || error != 0) {
+            WSASetLastError(error ? error : WSAGetLastError());
+            throw std::runtime_error(make_error_message());
+        }
+        if (blocking) {
+            u_long mode = 0;
+            if (ioctlsocket(_socket, FIONBIO, &mode) == SOCKET_ERROR) {
+                throw std::runtime_error(make_error_message());
+            }
+            _non_blocking = false;
+        }
+    }
+
+    void base_socket::deadline(std::chrono::milliseconds timeout) {
+        //winsock takes the timeout as a DWORD of milliseconds rather than a timeval
+        DWORD ms = static_cast<DWORD>(timeout.count());
+        if (setsockopt(_socket, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&ms), sizeof(ms)) == SOCKET_ERROR ||
+            setsockopt(_socket, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&ms), sizeof(ms)) == SOCKET_ERROR)
+        {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    void base_socket::no_delay(bool on) {
+        BOOL optval = on ? TRUE : FALSE;
+        if (setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&optval), sizeof(optval)) == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
+    void base_socket::cork(bool) {
+        throw std::runtime_error("TCP_CORK is not supported by winsock");
     }
 
     void base_socket::be_non_blocking() { 
@@ -119,11 +280,13 @@ namespace xsckt {
         if (ioctlsocket(_socket, FIONBIO, &mode) == SOCKET_ERROR) {
             throw std::runtime_error(make_error_message());
         }
+        _non_blocking = true;
     }
 
-    const size_t base_socket::peek() const {
+    size_t base_socket::peek() const {
         std::array<char, DEFAULT_BUFFER_SIZE>buffer;
         auto i = recv(_socket, &buffer.front(), buffer.size(), MSG_PEEK);
+        _meter_call(i);
         if (i == SOCKET_ERROR) {
             throw std::runtime_error(make_error_message());
         }
@@ -132,52 +295,154 @@ namespace xsckt {
 
     std::string base_socket::read(flag_t flags) const {
         std::array<char, DEFAULT_BUFFER_SIZE>buffer;
-        auto i = recv(_socket, &buffer.front(), buffer.size(), flags);
-        if (i == SOCKET_ERROR) {
-            throw std::runtime_error(make_error_message());
-        }
-        buffer[static_cast<size_t>(i)] = '\0';
-        return std::string(buffer.data());
+        auto i = read(buffer.data(), buffer.size(), flags);   //empty if it would block, as on Linux
+        return (i > 0) ? std::string(buffer.data(), static_cast<size_t>(i)) : std::string();
     }
 
     long base_socket::write(address_t& buffer, flag_t flags) const {
         auto i = send(_socket, buffer.c_str(), static_cast<int>(buffer.size()), flags);
+        _meter(direction_t::OUT, i);
         if (i == SOCKET_ERROR) {
             throw std::runtime_error(make_error_message());
         }
         return i;
     }
 
+    long base_socket::read(char* buffer, size_t length, flag_t flags) const {
+        auto i = recv(_socket, buffer, static_cast<int>(length), flags);
+        _meter(direction_t::IN, i);
+        if (i == SOCKET_ERROR && !would_block()) {
+            throw std::runtime_error(make_error_message());
+        }
+        return i;
+    }
+
+    long base_socket::write(const char* buffer, size_t length, flag_t flags) const {
+        auto i = send(_socket, buffer, static_cast<int>(length), flags);
+        _meter(direction_t::OUT, i);
+        if (i == SOCKET_ERROR && !would_block()) {
+            throw std::runtime_error(make_error_message());
+        }
+        return i;
+    }
+
     std::string base_socket::read_from(flag_t flags) {
         std::array<char, DEFAULT_BUFFER_SIZE> buffer;
+        auto i = read_from(buffer.data(), buffer.size(), flags);
+        return (i > 0) ? std::string(buffer.data(), static_cast<size_t>(i)) : std::string();
+    }
+
+    long base_socket::write_back(const std::string& buffer, flag_t flags) {
+        //transmit message in buffer
+        auto i = sendto(_socket,
+            buffer.c_str(),
+            static_cast<int>(buffer.size()),
+            flags,
+            reinterpret_cast<struct sockaddr*>(&_raddr),
+            sizeof(_raddr));
+        _meter(direction_t::OUT, i);
+        if (i == SOCKET_ERROR) { //return the number of bytes sent, or -1 if an error occurred.
+            throw std::runtime_error(make_error_message());
+        }
+        return i;
+    }
+
+    long base_socket::read_from(char* buffer, size_t length, flag_t flags) {
         int len_raddr = sizeof(_raddr);
         auto i = recvfrom(_socket,
-            &buffer.front(),
-            buffer.size(),
+            buffer,
+            static_cast<int>(length),
             flags,
             reinterpret_cast<struct sockaddr*>(&_raddr),
             &len_raddr);
-        if (i == SOCKET_ERROR) { //return the number of bytes received, or -1 if an error occurred.
+        _meter(direction_t::IN, i);
+        if (i == SOCKET_ERROR && !would_block()) { //return the number of bytes received, or -1 if an error occurred.
             throw std::runtime_error(make_error_message());
         }
-        buffer[static_cast<size_t>(i)] = '\0';
-        return std::string(buffer.data());
+        return i;
     }
 
-    long base_socket::write_back(const std::string& buffer, flag_t flags) {
-        //transmit message in buffer
+    long base_socket::write_back(const char* buffer, size_t length, flag_t flags) {
         auto i = sendto(_socket,
-            buffer.c_str(),
-            static_cast<int>(buffer.size()),
+            buffer,
+            static_cast<int>(length),
             flags,
             reinterpret_cast<struct sockaddr*>(&_raddr),
             sizeof(_raddr));
-        if (i == SOCKET_ERROR) { //return the number of bytes sent, or -1 if an error occurred.
+        _meter(direction_t::OUT, i);
+        if (i == SOCKET_ERROR && !would_block()) { //return the number of bytes sent, or -1 if an error occurred.
             throw std::runtime_error(make_error_message());
         }
         return i;
     }
 
+    long base_socket::write_v(const const_buffer* buffers, size_t count, flag_t flags) const {
+        io_vectors_t iov;
+        DWORD sent = 0;
+        auto rc = WSASend(_socket, iov.data(), _gather(buffers, count, iov), &sent, flags, nullptr, nullptr);
+        _meter(direction_t::OUT, (rc == SOCKET_ERROR) ? SOCKET_ERROR : static_cast<long>(sent));
+        if (rc == SOCKET_ERROR) {
+            if (!would_block()) {
+                throw std::runtime_error(make_error_message());
+            }
+            return SOCKET_ERROR;
+        }
+        return static_cast<long>(sent);
+    }
+
+    long base_socket::read_v(const mutable_buffer* buffers, size_t count, flag_t flags) const {
+        io_vectors_t iov;
+        DWORD received = 0;
+        DWORD in_out_flags = flags;
+        auto rc = WSARecv(_socket, iov.data(), _gather(buffers, count, iov), &received, &in_out_flags, nullptr, nullptr);
+        _meter(direction_t::IN, (rc == SOCKET_ERROR) ? SOCKET_ERROR : static_cast<long>(received));
+        if (rc == SOCKET_ERROR) {
+            if (!would_block()) {
+                throw std::runtime_error(make_error_message());
+            }
+            return SOCKET_ERROR;
+        }
+        return static_cast<long>(received);
+    }
+
+    long base_socket::write_back_v(const const_buffer* buffers, size_t count, flag_t flags) {
+        if (count > MAX_IO_VECTORS) {
+            throw std::runtime_error("write_back_v: too many buffers for one datagram");
+        }
+        io_vectors_t iov;
+        DWORD sent = 0;
+        auto rc = WSASendTo(_socket, iov.data(), _gather(buffers, count, iov), &sent, flags,
+            reinterpret_cast<struct sockaddr*>(&_raddr), sizeof(_raddr), nullptr, nullptr);
+        _meter(direction_t::OUT, (rc == SOCKET_ERROR) ? SOCKET_ERROR : static_cast<long>(sent));
+        if (rc == SOCKET_ERROR) {
+            if (!would_block()) {
+                throw std::runtime_error(make_error_message());
+            }
+            return SOCKET_ERROR;
+        }
+        return static_cast<long>(sent);
+    }
+
+    long base_socket::read_from_v(const mutable_buffer* buffers, size_t count, flag_t flags) {
+        io_vectors_t iov;
+        DWORD received = 0;
+        DWORD in_out_flags = flags;
+        int len_raddr = sizeof(_raddr);
+        auto rc = WSARecvFrom(_socket, iov.data(), _gather(buffers, count, iov), &received, &in_out_flags,
+            reinterpret_cast<struct sockaddr*>(&_raddr), &len_raddr, nullptr, nullptr);
+        _meter(direction_t::IN, (rc == SOCKET_ERROR) ? SOCKET_ERROR : static_cast<long>(received));
+        if (rc == SOCKET_ERROR) {
+            //a datagram longer than the buffers is truncated, as recvfrom
+            if (WSAGetLastError() != WSAEMSGSIZE) {
+                if (!would_block()) {
+                    throw std::runtime_error(make_error_message());
+                }
+                return SOCKET_ERROR;
+            }
+        }
+        return static_cast<long>(received);
+    }
+
     std::string base_socket::hostname() const
     {
         return std::string();
@@ -196,6 +461,17 @@ namespace xsckt {
         }
     }
 
+    void base_socket::share_port() {
+        //winsock has no SO_REUSEPORT and SO_REUSEADDR does not load balance
+        throw std::runtime_error("SO_REUSEPORT is not supported by winsock");
+    }
+
+    void base_socket::set_option(int level, int name, int value) {
+        if (setsockopt(_socket, level, name, reinterpret_cast<const char*>(&value), sizeof(value)) == SOCKET_ERROR) {
+            throw std::runtime_error(make_error_message());
+        }
+    }
+
     void base_socket::stop(action_t action) {
         switch (action) {
         case action_t::WRITE:
@@ -216,6 +492,128 @@ namespace xsckt {
         }
     }
 
+    long base_socket::read_batch(datagram_t* datagrams, size_t count, flag_t flags) {
+        //winsock has no recvmmsg, loop recvfrom for what is already queued once the first datagram is in
+        auto n = (count < MAX_BATCH_DATAGRAMS) ? count : MAX_BATCH_DATAGRAMS;
+        long received = 0;
+        while (static_cast<size_t>(received) < n) {
+            if (received > 0) {
+                u_long queued = 0;
+                if (ioctlsocket(_socket, FIONREAD, &queued) == SOCKET_ERROR || queued == 0) {
+                    break;
+                }
+            }
+            auto& datagram = datagrams[received];
+            int len_peer = sizeof(datagram.peer);
+            auto i = recvfrom(_socket,
+                datagram.data,
+                static_cast<int>(datagram.capacity),
+                flags,
+                reinterpret_cast<struct sockaddr*>(&datagram.peer),
+                &len_peer);
+            _meter(direction_t::IN, i);
+            if (i == SOCKET_ERROR) {
+                if (WSAGetLastError() == WSAEMSGSIZE) {
+                    i = static_cast<int>(datagram.capacity);    // truncated, as recvmmsg
+                }
+                else if (received == 0 && !would_block()) {
+                    throw std::runtime_error(make_error_message());
+                }
+                else {
+                    break;
+                }
+            }
+            datagram.size = static_cast<size_t>(i);
+            ++received;
+        }
+        return (received > 0) ? received : SOCKET_ERROR;
+    }
+
+    long base_socket::write_batch(const datagram_t* datagrams, size_t count, flag_t flags) {
+        //winsock has no sendmmsg, loop sendto until the send buffer fills
+        auto n = (count < MAX_BATCH_DATAGRAMS) ? count : MAX_BATCH_DATAGRAMS;
+        long sent = 0;
+        while (static_cast<size_t>(sent) < n) {
+            auto& datagram = datagrams[sent];
+            auto i = sendto(_socket,
+                datagram.data,
+                static_cast<int>(datagram.size),
+                flags,
+                reinterpret_cast<const struct sockaddr*>(&datagram.peer),
+                sizeof(datagram.peer));
+            _meter(direction_t::OUT, i);
+            if (i == SOCKET_ERROR) {
+                if (sent == 0 && !would_block()) {
+                    throw std::runtime_error(make_error_message());
+                }
+                break;
+            }
+            ++sent;
+        }
+        return (sent > 0) ? sent : SOCKET_ERROR;
+    }
+
+    void base_socket::segment_offload(unsigned short) {
+        throw std::runtime_error("UDP_SEGMENT is not supported by winsock");
+    }
+
+    void base_socket::receive_offload() {
+        throw std::runtime_error("UDP_GRO is not supported by winsock");
+    }
+
+    long base_socket::read_from_segments(char* buffer, size_t length, unsigned short& segment_size, flag_t flags) {
+        //never coalesced without receive_offload, so each read is one datagram
+        auto i = read_from(buffer, length, flags);
+        segment_size = (i > 0) ? static_cast<unsigned short>(i) : 0;
+        return i;
+    }
+
+    long base_socket::send_file(int file, long long offset, size_t length) {
+        //TransmitFile sends from the file position, and at most 2^31 - 2 bytes a call
+        auto h = reinterpret_cast<HANDLE>(_get_osfhandle(file));
+        LARGE_INTEGER position;
+        position.QuadPart = offset;
+        if (h == INVALID_HANDLE_VALUE || !SetFilePointerEx(h, position, nullptr, FILE_BEGIN)) {
+            throw std::runtime_error("send_file: bad file descriptor");
+        }
+        //TransmitFile stops at the end of the file without saying so, and takes a count of 0 as the whole file,
+        //so the count is cut to what the file has left first and is then what a successful call sent
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(h, &size)) {
+            throw std::runtime_error("send_file: bad file descriptor");
+        }
+        auto left = (offset < size.QuadPart) ? static_cast<unsigned long long>(size.QuadPart - offset) : 0ULL;
+        left = (length < left) ? length : left;
+        if (left == 0) {
+            return 0;
+        }
+        auto n = static_cast<DWORD>((left < 0x7ffffffe) ? left : 0x7ffffffe);
+        auto transmitted = TransmitFile(_socket, h, n, 0, nullptr, nullptr, TF_USE_DEFAULT_WORKER);
+        _meter(direction_t::OUT, transmitted ? static_cast<long>(n) : SOCKET_ERROR);
+        if (!transmitted) {
+            if (!would_block()) {
+                throw std::runtime_error(make_error_message());
+            }
+            return SOCKET_ERROR;
+        }
+        return static_cast<long>(n);
+    }
+
+    void base_socket::zero_copy(size_t threshold) {
+        if (threshold > 0) {
+            throw std::runtime_error("MSG_ZEROCOPY is not supported by winsock");
+        }
+    }
+
+    long base_socket::write_zero_copy(const char* buffer, size_t length, zero_copy_t& token, flag_t flags) {
+        token = 0;  //always copied
+        return write(buffer, length, flags);
+    }
+
+    bool base_socket::is_sent(zero_copy_t) {
+        return true;
+    }
+
     int base_socket::_getaddrinfo(const std::string& address, const unsigned short port) {
         // get server ip fit args
         return getaddrinfo(address.c_str(), std::to_string(port).c_str(), &_hints, &_long_addr);  
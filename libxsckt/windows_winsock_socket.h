@@ -15,12 +15,12 @@ namespace xsckt {
     /**
      * @brief The multipurpose base_socket class provides WINDOWS OS specific *both* client and server behaviour for (all) protocols.
      * @note Only TCP & UDP implemented so far
-     * @implements socketable interface
+     * @implements bsd_interface statically, its members are not virtual - wrap it in a bsd_adapter where the interface is wanted
      * @version 0.5
      * Although somewhat monolithic it encapsulates all of the OS specific networking logic in one place
      * which simplifies cross-platform development and makes for a very flexible base for a factory to use.
      */
-    class base_socket : public bsd_interface {
+    class base_socket {
 
         static const int MAX_BACKLOG = SOMAXCONN;
         //static constexpr int MAX_BACKLOG = SOMAXCONN_HINT(200);
@@ -30,22 +30,31 @@ namespace xsckt {
         /**
          * @brief base_socket::base_socket - constructs an easily restartable socket from a socket file descriptor.
          * @param socket - sockfd_t socket file descriptor
+         * @param sync - blocking mode of the constructed socket
          */
-        explicit base_socket(const sockfd_t socket);
+        explicit base_socket(const sockfd_t socket, blocking_t sync = blocking_t::BLOCKING);
 
         /**
          * @brief base_socket
          * @param address_family
          * @param socket_type
          * @param protocol
+         * @param sync - blocking mode of the constructed socket
          */
-        base_socket(const short address_family, const int socket_type, const int protocol);
+        base_socket(const short address_family, const int socket_type, const int protocol, blocking_t sync = blocking_t::BLOCKING);
 
-        base_socket(const base_socket&) = default;
+        /**
+         * @brief base_socket - takes over the other's socket, which is left without one so only this socket closes it
+         */
+        base_socket(base_socket&& other) noexcept;
+
+        base_socket& operator= (base_socket&& other) noexcept;
 
-        base_socket& operator= (const base_socket&) = default;
+        base_socket(const base_socket&) = delete;
 
-        virtual ~base_socket() override;
+        base_socket& operator= (const base_socket&) = delete;
+
+        ~base_socket();
 
         /**
          * @brief bind -  server side, associates a socket with an address.
@@ -55,27 +64,33 @@ namespace xsckt {
          * @param address - text format Internet address
          * @param port - port number
          */
-        virtual void bind_to(address_t& address, port_t port) override;
+        void bind_to(address_t& address, port_t port);
 
         /**
          * @brief listen() -  server side, prepares it for incoming connections, *after* a socket has been associated with an address.
          * However, this is only necessary for the stream-oriented (connection-oriented) data modes, i.e., for socket types (SOCK_STREAM, SOCK_SEQPACKET).
          * @return int newly created socket file descriptor
          */
-        virtual void listen_to() override;
+        void listen_to();
+
+        /**
+         * @brief listen_to - as listen_to, with a pending connection queue of backlog rather than MAX_BACKLOG
+         * @param backlog - the kernel caps it at its own somaxconn
+         */
+        void listen_to(int backlog);
 
         /**
          *@brief server_is_listening
          * @return true if passive socket that can accept connection(s)
          */
-        virtual bool is_listening() const override;
+        bool is_listening() const;
 
         /**
          * @brief accept -  server side, when listening for stream-oriented connections, it creates a new *active* socket for each connection and removes the connection from the listening queue.
          * @note datagram sockets do not require processing by accept() since the receiver may immediately respond to the request using the listening socket.
          * @return unsigned int newly created socket file descriptor
          */
-        virtual sockfd_t accept_from() override;
+        sockfd_t accept_from();
 
         /**
          * @brief connect -  client side, establishes a direct communication link to a specific remote host identified by its address and port number.
@@ -85,13 +100,43 @@ namespace xsckt {
          * @param address - the address to which datagrams are sent by default, and the only address from which datagrams are received.
          * @param port - port number
          */
-        virtual void connect_to(address_t& address, port_t port) override;
+        void connect_to(address_t& address, port_t port);
+
+        /**
+         * @brief connect_to - as connect_to, but giving up after timeout rather than waiting out the kernel's own connect timeout
+         * @note for blocking sockets: the connect is made non-blocking and waited for with poll, then the socket is set blocking again;
+         * a non-blocking socket stays non-blocking
+         * @note on failure, or when timeout passes first, throws an exception
+         * @param timeout - NO_TIMEOUT is a plain connect_to
+         */
+        void connect_to(address_t& address, port_t port, std::chrono::milliseconds timeout);
+
+        /**
+         * @brief deadline - bound how long a blocking read or write waits for the peer (SO_RCVTIMEO and SO_SNDTIMEO)
+         * @note a read or write that times out throws (WSAETIMEDOUT) and winsock leaves the socket in an indeterminate state, close it
+         * @param timeout - NO_TIMEOUT waits indefinitely again
+         */
+        void deadline(std::chrono::milliseconds timeout);
+
+        /**
+         * @brief no_delay - send small writes straight away rather than holding them back until earlier data is acknowledged (TCP_NODELAY)
+         * for request/response protocols that already batch their own writes, where Nagle's algorithm only adds latency
+         * @param on - false restores Nagle's algorithm
+         */
+        void no_delay(bool on = true);
+
+        /**
+         * @brief cork - hold back partial segments until uncorked or a full segment is queued (TCP_CORK), so several writes go out as few packets
+         * @note winsock has no TCP_CORK, throws
+         * @param on - false sends whatever is held back at once
+         */
+        void cork(bool on = true);
 
         /**
          * @brief be_non_blocking - set this socket to non-blocking mode.
          * by default sockets are created in blocking mode
          */
-        virtual void be_non_blocking() override;
+        void be_non_blocking();
 
         /**
         * @brief peek - Peeks at the incoming data.
@@ -100,14 +145,14 @@ namespace xsckt {
         * (or recvfrom) function, which may not be the same as the total amount of data queued on the socket.
         * @return size_t - the amount of data that can be read
         */
-        virtual const size_t peek() const override;
+        size_t peek() const;
 
         /**
          * @brief read - read a message from this socket if connected
          * @param flags - formed by ORing one or more of: MSG_CMSG_CLOEXEC, MSG_DONTWAIT, MSG_ERRQUEUE, MSG_OOB, MSG_PEEK, MSG_TRUNC, MSG_WAITALL - defaults to none
-         * @return string - the message
+         * @return string - the message, empty on orderly shutdown by the peer or, with would_block() true, when no data is ready
          */
-        virtual std::string read(flag_t flags = 0) const override;
+        std::string read(flag_t flags = 0) const;
 
         /**
          * @brief write - write a message to this socket if connected
@@ -115,14 +160,32 @@ namespace xsckt {
          * @param flags - formed by ORing one or more of: MSG_CONFIRM, MSG_DONTROUTE, MSG_DONTWAIT, MSG_EOR, MSG_MORE, MSG_NOSIGNAL, MSG_OOB - defaults to none.
          * @return long - the number of bytes written
          */
-        virtual long write(address_t& buffer, flag_t flags = 0) const override;
+        long write(address_t& buffer, flag_t flags = 0) const;
+
+        /**
+         * @brief read - read into a caller owned buffer from this socket if connected, without allocating or truncating at zero bytes
+         * @param buffer - where to put the data
+         * @param length - size of buffer
+         * @param flags - as read
+         * @return long - the number of bytes read, 0 on orderly shutdown by the peer, -1 with would_block() true if no data is ready
+         */
+        long read(char* buffer, size_t length, flag_t flags = 0) const;
+
+        /**
+         * @brief write - write from a caller owned buffer to this socket if connected
+         * @param buffer - the bytes to write
+         * @param length - number of bytes to write
+         * @param flags - as write
+         * @return long - the number of bytes written, -1 with would_block() true if the send buffer is full
+         */
+        long write(const char* buffer, size_t length, flag_t flags = 0) const;
 
         /**
          * @brief read_from - receive data on a socket whether or not it is connection-oriented.
          * @param flags - formed by ORing one or more of: MSG_CMSG_CLOEXEC, MSG_DONTWAIT, MSG_ERRQUEUE, MSG_OOB, MSG_PEEK, MSG_TRUNC, MSG_WAITALL, MSG_EOR, MSG_TRUNC, MSG_CTRUNC, MSG_ERRQUEUE - defaults to none
-         * @return string - the message
+         * @return string - the message, empty with would_block() true when no datagram is ready
          */
-        virtual std::string read_from(flag_t flags = 0) override;
+        std::string read_from(flag_t flags = 0);
 
         /**
          * @brief write_back - transmit a message to back the socket that has been read/read_from
@@ -130,24 +193,181 @@ namespace xsckt {
          * @param flags - formed by ORing one or more of: MSG_CONFIRM, MSG_DONTROUTE, MSG_DONTWAIT, MSG_EOR, MSG_MORE, MSG_NOSIGNAL, MSG_OOB - defaults to none.
          * @return long - the number of bytes written
          */
-        virtual long write_back(const std::string& buffer, flag_t flags = 0) override;
+        long write_back(const std::string& buffer, flag_t flags = 0);
+
+        /**
+         * @brief read_from - receive a datagram into a caller owned buffer, remembering the sender for write_back
+         * @param buffer - where to put the data
+         * @param length - size of buffer, a longer datagram is truncated
+         * @param flags - as read_from
+         * @return long - the number of bytes received, -1 with would_block() true if no datagram is ready
+         */
+        long read_from(char* buffer, size_t length, flag_t flags = 0);
+
+        /**
+         * @brief write_back - transmit a caller owned buffer back to the socket that has been read/read_from
+         * @param buffer - the bytes to write
+         * @param length - number of bytes to write
+         * @param flags - as write_back
+         * @return long - the number of bytes written, -1 with would_block() true if the send buffer is full
+         */
+        long write_back(const char* buffer, size_t length, flag_t flags = 0);
+
+        /**
+         * @brief write_v - gather several caller owned buffers into one write to this socket if connected, e.g. a header and its payload
+         * @note a stream socket may take only part, step the views past the bytes written with consume and call again for the rest;
+         * at most MAX_IO_VECTORS views are sent per call
+         * @param buffers - views of the bytes to write, in order
+         * @param count - number of views
+         * @param flags - as write
+         * @return long - the number of bytes written, -1 with would_block() true if the send buffer is full
+         */
+        long write_v(const const_buffer* buffers, size_t count, flag_t flags = 0) const;
+
+        /**
+         * @brief read_v - scatter one read from this socket if connected across several caller owned buffers, filling each in turn
+         * @param buffers - views of where to put the data, in order
+         * @param count - number of views, at most MAX_IO_VECTORS are filled per call
+         * @param flags - as read
+         * @return long - the number of bytes read, 0 on orderly shutdown by the peer, -1 with would_block() true if no data is ready
+         */
+        long read_v(const mutable_buffer* buffers, size_t count, flag_t flags = 0) const;
+
+        /**
+         * @brief write_back_v - gather several caller owned buffers into one datagram back to the socket that has been read/read_from
+         * @note throws if count is more than MAX_IO_VECTORS rather than send a partial datagram
+         * @param buffers - views of the bytes to write, in order
+         * @param count - number of views
+         * @param flags - as write_back
+         * @return long - the number of bytes written, -1 with would_block() true if the send buffer is full
+         */
+        long write_back_v(const const_buffer* buffers, size_t count, flag_t flags = 0);
+
+        /**
+         * @brief read_from_v - scatter one datagram across several caller owned buffers, remembering the sender for write_back
+         * @param buffers - views of where to put the data, in order, a longer datagram is truncated
+         * @param count - number of views, at most MAX_IO_VECTORS are filled
+         * @param flags - as read_from
+         * @return long - the number of bytes received, -1 with would_block() true if no datagram is ready
+         */
+        long read_from_v(const mutable_buffer* buffers, size_t count, flag_t flags = 0);
 
         /**
          * @brief hostname - returns the standard host name for the local computer
          * @return std::string local machine name
          */
-        virtual std::string hostname() const override;
+        std::string hostname() const;
 
         /**
          * @brief reset - enable kernel reuse addresses and ports that may already be active/tied
          */
-        virtual void reset() override;
+        void reset();
+
+        /**
+         * @brief share_port - let several sockets bind the same address and port, the kernel then spreads incoming connections across them
+         * @note must be called before bind_to
+         */
+        void share_port();
+
+        /**
+         * @brief set_option - setsockopt an int valued option, for the tunings without a method of their own
+         * @note throws if the option is refused
+         * @param level - e.g. SOL_SOCKET or IPPROTO_TCP
+         * @param name - e.g. SO_RCVBUF or TCP_QUICKACK
+         */
+        void set_option(int level, int name, int value);
 
         /**
          * @brief stop - causes all or part of a full-duplex connection on this socket to be shut down.
          * @param action - SHUT_RD, further receptions will be disallowed; SHUT_WR further transmissions will be disallowed; SHUT_RDWR, further receptions and transmissions will be disallowed.
          */
-        virtual void stop(action_t action) override;
+        void stop(action_t action);
+
+        /**
+         * @brief read_batch - receive up to count datagrams in one go, each with its own sender, so replies can go to every peer not just the last
+         * @note waits only for the first datagram, then takes what else is already queued
+         * @param datagrams - slots to fill, data and capacity set by the caller
+         * @param count - number of slots, at most MAX_BATCH_DATAGRAMS are filled per call
+         * @param flags - as read_from
+         * @return long - number of datagrams received, -1 with would_block() true if none is ready
+         */
+        long read_batch(datagram_t* datagrams, size_t count, flag_t flags = 0);
+
+        /**
+         * @brief write_batch - send up to count datagrams in one go, each to its own peer, e.g. the replies to a read_batch
+         * @param datagrams - size bytes of data go to peer
+         * @param count - number of datagrams, at most MAX_BATCH_DATAGRAMS are sent per call
+         * @param flags - as write_back
+         * @return long - number of datagrams sent, the rest are left for the next call, -1 with would_block() true if none could be
+         */
+        long write_batch(const datagram_t* datagrams, size_t count, flag_t flags = 0);
+
+        /**
+         * @brief segment_offload - have the kernel cut each write into datagrams of segment_size bytes (UDP GSO), the last may be shorter
+         * one write of up to MAX_OFFLOAD_SEGMENTS segments (and 64K in all) then costs one trip through the stack instead of one per datagram
+         * @note Linux 4.18+, 0 turns it off
+         * @param segment_size - payload bytes per datagram, at most the path MTU less headers
+         */
+        void segment_offload(unsigned short segment_size);
+
+        /**
+         * @brief receive_offload - let the kernel hand over back to back datagrams from one sender as a single coalesced buffer (UDP GRO)
+         * @note Linux 5.0+, read with read_from_segments into a 64K buffer to learn where each datagram ends
+         */
+        void receive_offload();
+
+        /**
+         * @brief read_from_segments - receive a datagram, or with receive_offload a run of equal sized datagrams, remembering the sender for write_back
+         * @param buffer - where to put the data
+         * @param length - size of buffer
+         * @param segment_size - set to the size of each datagram in the buffer, the last may be shorter
+         * @param flags - as read_from
+         * @return long - the number of bytes received, -1 with would_block() true if no datagram is ready
+         */
+        long read_from_segments(char* buffer, size_t length, unsigned short& segment_size, flag_t flags = 0);
+
+        /**
+         * @brief send_file - send part of a file straight from the page cache, without reading it into user memory
+         * @param file - open file descriptor
+         * @param offset - where in the file to start; winsock sends from the file position, so it is moved
+         * @param length - most bytes to send
+         * @return long - the number of bytes sent, advance offset by it and call again for the rest, -1 with would_block() true if the send buffer is full
+         */
+        long send_file(int file, long long offset, size_t length);
+
+        /**
+         * @brief zero_copy - send writes of at least threshold bytes from write_zero_copy straight from the caller's buffer (MSG_ZEROCOPY)
+         * the pages are pinned rather than copied into the kernel, so the buffer must not change until is_sent says the send is done
+         * @note Linux 4.14+, pays off only for large sends - over loopback the kernel copies anyway
+         * @param threshold - smaller writes are copied as usual, 0 turns zero copy off
+         */
+        void zero_copy(size_t threshold = ZERO_COPY_THRESHOLD);
+
+        /**
+         * @brief write_zero_copy - write from a caller owned buffer, zero copy if it is switched on and the write is large enough
+         * @param buffer - the bytes to write, left untouched until is_sent(token)
+         * @param length - number of bytes to write
+         * @param token - set to the completion to wait for, 0 if the bytes were copied and the buffer is free already
+         * @param flags - as write
+         * @return long - the number of bytes written, -1 with would_block() true if the send buffer is full
+         */
+        long write_zero_copy(const char* buffer, size_t length, zero_copy_t& token, flag_t flags = 0);
+
+        /**
+         * @brief is_sent - drain the completions the kernel has queued and say if a zero copy write is done with its buffer
+         * completions arrive in order, so the token of the last write from a buffer covers the earlier ones
+         * @param token - from write_zero_copy
+         * @return bool - true if the buffer may be reused
+         */
+        bool is_sent(zero_copy_t token);
+
+        /**
+         * @brief handle - the underlying socket file descriptor e.g. for registering with an event loop
+         * @return sockfd_t socket file descriptor
+         */
+        sockfd_t handle() const {
+            return _socket;
+        }
 
     private:
 
@@ -165,10 +385,16 @@ namespace xsckt {
         int _socket_type{ 0 };
         int _protocol{ 0 };
 
-        struct addrinfo* _long_addr;
+        struct addrinfo* _long_addr{ nullptr };  // only valid between _getaddrinfo and freeaddrinfo
         struct addrinfo _hints;
         struct sockaddr_in _raddr;
 
+        size_t _zero_copy_threshold{ 0 };       // 0 while zero copy is off
+        zero_copy_t _zero_copy_sent{ 0 };       // zero copy writes made
+        zero_copy_t _zero_copy_completed{ 0 };  // zero copy writes the kernel is done with
+
+        bool _non_blocking{ false };            // winsock cannot read the FIONBIO mode back, so it is remembered
+
     };
 
 }   /*! @} */
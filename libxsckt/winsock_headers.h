@@ -3,9 +3,12 @@
 #ifdef WIN32
 
 #pragma comment(lib, "WS2_32.lib")
+#pragma comment(lib, "Mswsock.lib")
 
 #include <winsock2.h>
 #include <ws2tcpip.h>
+#include <mswsock.h>
+#include <io.h>
 
 #include <string>
 #include <sstream>
@@ -40,6 +43,13 @@ namespace xsckt {
         return (!*msgbuf) ? std::string("undefined error") : std::string(msgbuf);
     }
 
+    /**
+     * @brief would_block - true if the last socket call on this thread failed only because a non-blocking socket was not ready
+     */
+    static inline bool would_block() {
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+    }
+
     //Windows specific...
 
     enum versions { v1_0 = 0x1, v1_1 = 0x101, v2_0 = 0x2, v2_1 = 0x102, v2_2 = 0x202 };
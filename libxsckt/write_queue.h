@@ -0,0 +1,241 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "xsckt.h"
+
+/**
+ * \addtogroup xsckt
+ * @{
+ */
+namespace xsckt {
+
+    /**
+     * @brief The write_queue class collects the writes of a handler turn for one connected stream multi_socket and sends them together.
+     * @version 0.1
+     * write copies into the queue, appending to the previous copy so a run of small replies becomes one buffer; write_view
+     * queues caller owned bytes without copying. Nothing is sent until flush, which gathers everything queued into as few
+     * write_v calls as MAX_IO_VECTORS allows, each but the last flagged MSG_MORE where the platform has it so the kernel
+     * fills whole segments rather than pushing a short one between calls.
+     * With a non-blocking socket flush sends what the socket takes and keeps the rest, in order, for the next flush on the
+     * writable event; writes queued in the meantime go out behind it.
+     * A peer that stops reading would make the queue grow without bound, so it has high and low watermarks: once queued()
+     * reaches the high one full() is true, and stays true until a flush brings it down to the low one, when on_drained is
+     * called. A server stops reading from a connection while its queue is full, so a slow consumer costs at most the high
+     * watermark in memory and holds up no one else.
+     * @note not thread safe - one write_queue per connection, and the socket must outlive it
+     */
+    template<XSCKT_STREAM_SOCKET socket_type>
+    class write_queue {
+
+    public:
+
+        /**
+         * @brief write_queue
+         * @param sckt - socket with write_v(const const_buffer*, size_t, flags)
+         * @param flush_threshold - write and write_view flush by themselves once this many bytes are queued, 0 leaves it to the caller
+         */
+        explicit write_queue(socket_type& sckt, size_t flush_threshold = LARGE_BUFFER_SIZE) :
+            _sckt(sckt), _flush_threshold(flush_threshold) {}
+
+        write_queue(const write_queue&) = delete;
+
+        write_queue& operator= (const write_queue&) = delete;
+
+        /**
+         * @brief watermarks - bound the queue, see full
+         * @param high - full() from this many bytes queued, 0 for no bound
+         * @param low - full() again false once a flush is down to this many, at most high
+         * @param on_drained - called at the end of the flush that brings a full queue down to low, e.g. to resume reading;
+         * it may queue more but must not destroy the queue
+         */
+        void watermarks(size_t high, size_t low, std::function<void()> on_drained = nullptr) {
+            _high = high;
+            _low = (low < high) ? low : high;
+            _on_drained = std::move(on_drained);
+        }
+
+        /**
+         * @brief full - the high watermark has been reached and the queue has not yet drained to the low one, stop producing
+         */
+        bool full() const {
+            return _full;
+        }
+
+        /**
+         * @brief write - queue a copy of the bytes
+         */
+        void write(const char* data, size_t size) {
+            if (size == 0) {
+                return;
+            }
+            if (!_segments.empty() && _segments.back().data == nullptr && _segments.back().offset + _segments.back().size == _bytes.size()) {
+                _segments.back().size += size;  // straight after the previous copy, widen it rather than adding a view
+            }
+            else {
+                _segments.push_back({ nullptr, _bytes.size(), size });
+            }
+            _bytes.insert(_bytes.end(), data, data + size);
+            _queued += size;
+            _check_high();
+            _auto_flush();
+        }
+
+        void write(const std::string& data) {
+            write(data.data(), data.size());
+        }
+
+        /**
+         * @brief write_view - queue caller owned bytes without copying them
+         * @note they must stay unchanged until empty() is true again
+         */
+        void write_view(const char* data, size_t size) {
+            if (size == 0) {
+                return;
+            }
+            _segments.push_back({ data, 0, size });
+            _queued += size;
+            _check_high();
+            _auto_flush();
+        }
+
+        /**
+         * @brief flush - send everything queued, as far as the socket will take it
+         * @return bool - true if the queue is empty, false if a non-blocking socket would block with bytes still queued
+         */
+        bool flush() {
+            while (_head < _segments.size()) {
+                std::array<const_buffer, MAX_IO_VECTORS> views;
+                size_t count = 0;
+                size_t size = 0;
+                for (auto i = _head; i < _segments.size() && count < views.size(); ++i, ++count) {
+                    views[count] = _view(_segments[i]);
+                    size += views[count].size;
+                }
+                auto last = _head + count == _segments.size();
+                auto i = _sckt.write_v(views.data(), count, last ? 0 : MORE);
+                if (i < 0) {
+                    _compact();
+                    _check_low();
+                    return false;
+                }
+                _consume(static_cast<size_t>(i));
+                if (static_cast<size_t>(i) < size) {
+                    _compact();     // the send buffer is full, a blocking socket loops round to wait
+                }
+            }
+            _segments.clear();
+            _bytes.clear();
+            _head = 0;
+            _check_low();
+            return true;
+        }
+
+        /**
+         * @brief queued - bytes written but not yet sent
+         */
+        size_t queued() const {
+            return _queued;
+        }
+
+        bool empty() const {
+            return _queued == 0;
+        }
+
+    private:
+
+#ifdef MSG_MORE
+        static const int MORE = MSG_MORE;
+#else
+        static const int MORE = 0;
+#endif
+
+        /**
+         * @brief segment_t - a run of queued bytes, copied into _bytes at offset when data is nullptr, caller owned otherwise
+         */
+        struct segment_t {
+            const char* data;
+            size_t offset;
+            size_t size;
+        };
+
+        const_buffer _view(const segment_t& segment) const {
+            return { segment.data ? segment.data + segment.offset : _bytes.data() + segment.offset, segment.size };
+        }
+
+        void _consume(size_t n) {
+            _queued -= n;
+            while (n > 0) {
+                auto& segment = _segments[_head];
+                auto used = (n < segment.size) ? n : segment.size;
+                segment.offset += used;
+                segment.size -= used;
+                n -= used;
+                if (segment.size == 0) {
+                    ++_head;
+                }
+            }
+        }
+
+        /**
+         * @brief _compact - drop the segments and copied bytes already sent, so a queue that never quite drains does not grow
+         */
+        void _compact() {
+            _segments.erase(_segments.begin(), _segments.begin() + static_cast<std::ptrdiff_t>(_head));
+            _head = 0;
+            //copies are appended in order, so everything before the first copy still queued has been sent
+            size_t sent = _bytes.size();
+            for (auto& segment : _segments) {
+                if (segment.data == nullptr) {
+                    sent = segment.offset;
+                    break;
+                }
+            }
+            if (sent > 0 && sent * 2 >= _bytes.size()) {
+                _bytes.erase(_bytes.begin(), _bytes.begin() + static_cast<std::ptrdiff_t>(sent));
+                for (auto& segment : _segments) {
+                    if (segment.data == nullptr) {
+                        segment.offset -= sent;
+                    }
+                }
+            }
+        }
+
+        void _check_high() {
+            if (_high && _queued >= _high) {
+                _full = true;
+            }
+        }
+
+        void _check_low() {
+            if (_full && _queued <= _low) {
+                _full = false;
+                if (_on_drained) {
+                    _on_drained();
+                }
+            }
+        }
+
+        void _auto_flush() {
+            if (_flush_threshold && _queued >= _flush_threshold) {
+                flush();
+            }
+        }
+
+        socket_type& _sckt;
+        size_t _flush_threshold;
+        std::vector<char> _bytes;           // copied writes, back to back
+        std::vector<segment_t> _segments;   // everything queued, in order
+        size_t _head{ 0 };                  // first segment not yet sent in full
+        size_t _queued{ 0 };
+        size_t _high{ 0 };
+        size_t _low{ 0 };
+        bool _full{ false };
+        std::function<void()> _on_drained;
+
+    };
+
+}   /*! @} */
@@ -2,6 +2,10 @@
 
 #include <string>
 
+#ifdef __cpp_concepts
+#include <concepts>
+#endif
+
 #ifdef WIN32
 
 #include "winsock_headers.h"
@@ -22,8 +26,61 @@
  */
 namespace xsckt {
 
+    /**
+     * @brief const_buffer - view of caller owned bytes to gather into one write_v/write_back_v
+     */
+    struct const_buffer {
+        const char* data;
+        size_t size;
+    };
+
+    /**
+     * @brief mutable_buffer - view of caller owned space to scatter one read_v/read_from_v into
+     */
+    struct mutable_buffer {
+        char* data;
+        size_t size;
+
+        operator const_buffer() const {
+            return { data, size };
+        }
+    };
+
+    /**
+     * @brief datagram_t - one slot of a read_batch/write_batch, a caller owned buffer and the peer it came from or goes to
+     */
+    struct datagram_t {
+        char* data;
+        size_t capacity;            // size of data, a longer datagram is truncated
+        size_t size;                // bytes received by read_batch, bytes to send for write_batch
+        struct sockaddr_in peer;    // sender filled in by read_batch, destination for write_batch
+    };
+
+    /**
+     * @brief consume - step a list of buffer views past the n bytes a vectored call transferred, ready for the retry
+     * @param buffers - first view, moved past the views used up and the one partly used trimmed in place
+     * @param count - number of views, reduced to those left
+     * @param n - bytes transferred
+     * @return bool - true if every view is used up
+     */
+    template<typename buffer_type>
+    bool consume(buffer_type*& buffers, size_t& count, size_t n) {
+        while (count > 0 && n >= buffers->size) {
+            n -= buffers->size;
+            ++buffers;
+            --count;
+        }
+        if (count > 0) {
+            buffers->data += n;
+            buffers->size -= n;
+        }
+        return count == 0;
+    }
+
 	/**
 	 * @brief BSD-esque abstract socket interface class for cross platform socket objects 
+	 * base_socket and the multi_sockets implement it statically, without virtual calls on the hot path; bsd_adapter wraps
+	 * one of them in it where the socket type has to be erased
 	 */
 	struct bsd_interface {
 
@@ -82,7 +139,7 @@ namespace xsckt {
         * (or recvfrom) function, which may not be the same as the total amount of data queued on the socket.
         * @return size_t - the amount of data that can be read
         */
-        virtual const size_t peek() const = 0;
+        virtual size_t peek() const = 0;
 
         /**
          * @brief read - read a message from this socket if connected
@@ -99,6 +156,24 @@ namespace xsckt {
          */
         virtual long write(address_t& buffer, flag_t flags = 0) const = 0;
 
+        /**
+         * @brief read - read into a caller owned buffer from this socket if connected, without allocating or truncating at zero bytes
+         * @param buffer - where to put the data
+         * @param length - size of buffer
+         * @param flags - as read
+         * @return long - the number of bytes read, 0 on orderly shutdown by the peer, -1 with would_block() true if no data is ready
+         */
+        virtual long read(char* buffer, size_t length, flag_t flags = 0) const = 0;
+
+        /**
+         * @brief write - write from a caller owned buffer to this socket if connected
+         * @param buffer - the bytes to write
+         * @param length - number of bytes to write
+         * @param flags - as write
+         * @return long - the number of bytes written, -1 with would_block() true if the send buffer is full
+         */
+        virtual long write(const char* buffer, size_t length, flag_t flags = 0) const = 0;
+
         /**
          * @brief read_from - receive data on a socket whether or not it is connection-oriented.
          * @param flags - formed by ORing one or more of: MSG_CMSG_CLOEXEC, MSG_DONTWAIT, MSG_ERRQUEUE, MSG_OOB, MSG_PEEK, MSG_TRUNC, MSG_WAITALL, MSG_EOR, MSG_TRUNC, MSG_CTRUNC, MSG_ERRQUEUE - defaults to none
@@ -114,6 +189,63 @@ namespace xsckt {
          */
         virtual long write_back(const std::string& buffer, flag_t flags = 0) = 0;
 
+        /**
+         * @brief read_from - receive a datagram into a caller owned buffer, remembering the sender for write_back
+         * @param buffer - where to put the data
+         * @param length - size of buffer, a longer datagram is truncated
+         * @param flags - as read_from
+         * @return long - the number of bytes received, -1 with would_block() true if no datagram is ready
+         */
+        virtual long read_from(char* buffer, size_t length, flag_t flags = 0) = 0;
+
+        /**
+         * @brief write_back - transmit a caller owned buffer back to the socket that has been read/read_from
+         * @param buffer - the bytes to write
+         * @param length - number of bytes to write
+         * @param flags - as write_back
+         * @return long - the number of bytes written, -1 with would_block() true if the send buffer is full
+         */
+        virtual long write_back(const char* buffer, size_t length, flag_t flags = 0) = 0;
+
+        /**
+         * @brief write_v - gather several caller owned buffers into one write to this socket if connected, e.g. a header and its payload
+         * @note a stream socket may take only part, step the views past the bytes written with consume and call again for the rest;
+         * at most MAX_IO_VECTORS views are sent per call
+         * @param buffers - views of the bytes to write, in order
+         * @param count - number of views
+         * @param flags - as write
+         * @return long - the number of bytes written, -1 with would_block() true if the send buffer is full
+         */
+        virtual long write_v(const const_buffer* buffers, size_t count, flag_t flags = 0) const = 0;
+
+        /**
+         * @brief read_v - scatter one read from this socket if connected across several caller owned buffers, filling each in turn
+         * @param buffers - views of where to put the data, in order
+         * @param count - number of views, at most MAX_IO_VECTORS are filled per call
+         * @param flags - as read
+         * @return long - the number of bytes read, 0 on orderly shutdown by the peer, -1 with would_block() true if no data is ready
+         */
+        virtual long read_v(const mutable_buffer* buffers, size_t count, flag_t flags = 0) const = 0;
+
+        /**
+         * @brief write_back_v - gather several caller owned buffers into one datagram back to the socket that has been read/read_from
+         * @note throws if count is more than MAX_IO_VECTORS rather than send a partial datagram
+         * @param buffers - views of the bytes to write, in order
+         * @param count - number of views
+         * @param flags - as write_back
+         * @return long - the number of bytes written, -1 with would_block() true if the send buffer is full
+         */
+        virtual long write_back_v(const const_buffer* buffers, size_t count, flag_t flags = 0) = 0;
+
+        /**
+         * @brief read_from_v - scatter one datagram across several caller owned buffers, remembering the sender for write_back
+         * @param buffers - views of where to put the data, in order, a longer datagram is truncated
+         * @param count - number of views, at most MAX_IO_VECTORS are filled
+         * @param flags - as read_from
+         * @return long - the number of bytes received, -1 with would_block() true if no datagram is ready
+         */
+        virtual long read_from_v(const mutable_buffer* buffers, size_t count, flag_t flags = 0) = 0;
+
         /**
          * @brief hostname - returns the standard host name for the local computer
          * @return std::string local machine name
@@ -136,6 +268,40 @@ namespace xsckt {
 
 	};
 
+#ifdef __cpp_concepts
+
+    /**
+     * @brief stream_socket - what the stream templates (stream_reader, write_queue, framed_socket, async_loop) need of a
+     * connected multi_socket: read(char*, size_t, flags), write(const char*, size_t, flags) and write_v, called directly
+     */
+    template<typename socket_type>
+    concept stream_socket = requires(socket_type& sckt, char* in, const char* out, const const_buffer* views, size_t n) {
+        { sckt.read(in, n, 0) } -> std::convertible_to<long>;
+        { sckt.write(out, n, 0) } -> std::convertible_to<long>;
+        { sckt.write_v(views, n, 0) } -> std::convertible_to<long>;
+    };
+
+    /**
+     * @brief datagram_socket - a multi_socket with read_from(char*, size_t, flags) and write_back(const char*, size_t, flags)
+     */
+    template<typename socket_type>
+    concept datagram_socket = requires(socket_type& sckt, char* in, const char* out, size_t n) {
+        { sckt.read_from(in, n, 0) } -> std::convertible_to<long>;
+        { sckt.write_back(out, n, 0) } -> std::convertible_to<long>;
+    };
+
+    //template parameter kinds for the socket templates, checked where concepts are available
+    #define XSCKT_STREAM_SOCKET stream_socket
+    #define XSCKT_DATAGRAM_SOCKET datagram_socket
+
+#else
+
+    //before C++20 the templates take any type, and a socket missing an operation fails to compile where it is called
+    #define XSCKT_STREAM_SOCKET typename
+    #define XSCKT_DATAGRAM_SOCKET typename
+
+#endif // __cpp_concepts
+
 }   /*! @} */
 
 /* macro defs:
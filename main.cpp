@@ -1,8 +1,17 @@
 #include <iostream>
+#include <fstream>
+#include <chrono>
 
 #include "tcp_server.h"
+#include "tcp_sharded_server.h"
+#include "tcp_client.h"
 
 #define SERVER
+//#define EVENT_LOOP_MODEL	// serve every client from one epoll event loop thread (Linux)
+//#define SHARDED_MODEL		// one SO_REUSEPORT listener and event loop per core (Linux)
+//#define IO_URING_MODEL	// batched io_uring accepts, reads and writes (Linux, build with XSCKT_IO_URING)
+//#define COROUTINE_MODEL	// a coroutine per client co_awaiting its socket (Linux, build as C++20)
+//#define CLIENT_INPUT "requests.txt"	// without SERVER, pipeline every line of this file rather than prompting
 
 int main() {
 
@@ -13,7 +22,17 @@ int main() {
 
 #ifdef SERVER
 	try {
+#if defined(SHARDED_MODEL)
+		xsckt::tcp_sharded_server s(xsckt::LOOPBACK_ADDR, xsckt::DEFAULT_PORT);
+#elif defined(COROUTINE_MODEL)
+		xsckt::tcp_server s(xsckt::LOOPBACK_ADDR, xsckt::DEFAULT_PORT, xsckt::tcp_server::model_t::COROUTINE);
+#elif defined(IO_URING_MODEL)
+		xsckt::tcp_server s(xsckt::LOOPBACK_ADDR, xsckt::DEFAULT_PORT, xsckt::tcp_server::model_t::IO_URING);
+#elif defined(EVENT_LOOP_MODEL)
+		xsckt::tcp_server s(xsckt::LOOPBACK_ADDR, xsckt::DEFAULT_PORT, xsckt::tcp_server::model_t::EVENT_LOOP);
+#else
 		xsckt::tcp_server s(xsckt::LOOPBACK_ADDR, xsckt::DEFAULT_PORT);
+#endif
 		s.run();
 	}
 	catch (std::runtime_error& e) {
@@ -21,8 +40,18 @@ int main() {
 	}
 #else
 	try {
-		xsckt::tcp_echo_client c(net::LOOPBACK_ADDR, net::DEFAULT_PORT);
+		xsckt::tcp_echo_client c(xsckt::LOOPBACK_ADDR, xsckt::DEFAULT_PORT);
+#ifdef CLIENT_INPUT
+		std::ifstream input(CLIENT_INPUT);
+		if (!input) {
+			throw std::runtime_error(std::string("cannot open ") + CLIENT_INPUT);
+		}
+		auto started = std::chrono::steady_clock::now();
+		auto replies = c.run_pipelined(input, std::cout);
+		std::cerr << replies << " replies in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count() << "s\n";
+#else
 		c.run();
+#endif
 	}
 	catch (std::runtime_error& e) {
 		std::cerr << e.what() << "\n\n";
@@ -33,7 +62,9 @@ int main() {
 	xsckt::cleanup();
 #endif
 
+#ifdef WIN32
 	system("pause");
+#endif
 	return 0;
   
 }
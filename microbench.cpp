@@ -0,0 +1,371 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+#include "libxsckt/socket_factory.h"
+#include "libxsckt/bsd_adapter.h"
+#include "libxsckt/stream_reader.h"
+#include "libxsckt/buffer_pool.h"
+
+/*
+ * xsckt_microbench - what each layer of the socket hot path costs per call
+ *
+ * Every connected pair is driven from the one thread, a write on one end then reads on the other until it has all
+ * arrived, through each layer in turn:
+ *	syscall			send/recv (sendto/recvfrom) on the bare handles
+ *	base_socket		the non-virtual wrapper, error checks included
+ *	bsd_interface	the same calls through a bsd_adapter, one virtual call each
+ *	multi_socket	tcp_active_socket/udp_server_socket, base_socket's members exposed by socket_factory.h
+ *	std::string		read()/read_from() returning a string, the 512 byte stack buffer copied into it
+ *	read_pooled		read_pooled()/read_from_pooled() into a buffer_pool chunk, reused once the last handle is dropped
+ * and prints ns/op and heap allocations/op for several message sizes. The differences between the rows are the cost of
+ * each layer; the syscall row is the floor. The sockets have no virtual members, so the bsd_interface row is what every
+ * call cost while base_socket derived from it.
+ */
+
+namespace {
+
+	//every allocation in the process is counted, the benchmark is single threaded
+	unsigned long long allocations = 0;
+
+}
+
+void* operator new(size_t size) {
+	++allocations;
+	if (auto p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	std::free(p);
+}
+
+namespace {
+
+	using namespace xsckt;
+	using clock = std::chrono::steady_clock;
+
+#ifdef WIN32
+	const int NO_SIGNAL = 0;
+	void close_handle(sockfd_t sockfd) { closesocket(sockfd); }
+#else
+	const int NO_SIGNAL = MSG_NOSIGNAL;
+	void close_handle(sockfd_t sockfd) { close(sockfd); }
+#endif
+
+	const size_t SIZES[] = { 16, 512, 4096 };
+	const size_t UDP_SIZES[] = { 16, 512, 1400 };
+
+	/**
+	 * @brief measure - ns and allocations per call of op, after a warm up
+	 */
+	template<typename op_type>
+	void measure(const char* layer, size_t iterations, op_type&& op) {
+		for (size_t i = 0; i < iterations / 10 + 1; ++i) {
+			op();
+		}
+		auto allocated = allocations;
+		auto start = clock::now();
+		for (size_t i = 0; i < iterations; ++i) {
+			op();
+		}
+		auto ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+		std::cout << "    " << std::left << std::setw(16) << layer << std::right << std::fixed
+			<< std::setprecision(1) << std::setw(10) << ns / static_cast<double>(iterations) << " ns/op"
+			<< std::setprecision(2) << std::setw(8) << static_cast<double>(allocations - allocated) / static_cast<double>(iterations) << " allocs/op\n";
+	}
+
+	unsigned short local_port(sockfd_t sockfd) {
+		struct sockaddr_in addr;
+		socklen_t len = sizeof(addr);
+		if (getsockname(sockfd, reinterpret_cast<struct sockaddr*>(&addr), &len) == SOCKET_ERROR) {
+			throw std::runtime_error(make_error_message());
+		}
+		return ntohs(addr.sin_port);
+	}
+
+	struct sockaddr_in loopback(unsigned short port) {
+		struct sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons(port);
+		return addr;
+	}
+
+	/**
+	 * @brief make_pair - two connected stream handles, over loopback TCP or a Unix socketpair
+	 */
+	void make_pair(bool unix_pair, sockfd_t& a, sockfd_t& b) {
+#ifdef __linux__
+		if (unix_pair) {
+			int fds[2];
+			if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == SOCKET_ERROR) {
+				throw std::runtime_error(make_error_message());
+			}
+			a = fds[0];
+			b = fds[1];
+			return;
+		}
+#endif
+		tcp_server_socket listener(LOOPBACK_ADDR, 0);
+		a = socket(AF_INET, SOCK_STREAM, 0);
+		auto addr = loopback(local_port(listener.handle()));
+		if (connect(a, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == SOCKET_ERROR) {
+			throw std::runtime_error(make_error_message());
+		}
+		b = listener.accept_from();
+	}
+
+	/**
+	 * @brief transfer - write size bytes on one end, read until they have all arrived on the other
+	 */
+	template<typename write_type, typename read_type>
+	void transfer(size_t size, write_type&& write, read_type&& read) {
+		if (write() != static_cast<long>(size)) {
+			throw std::runtime_error("short write");
+		}
+		for (size_t got = 0; got < size;) {
+			auto i = read(size - got);
+			if (i <= 0) {
+				throw std::runtime_error("connection closed");
+			}
+			got += static_cast<size_t>(i);
+		}
+	}
+
+	void stream_layers(const char* name, bool unix_pair) {
+		for (auto size : SIZES) {
+			std::cout << name << " " << size << "B write + read\n";
+			std::vector<char> out(size, 'x');
+			std::vector<char> in(size);
+			std::string message(size, 'x');
+			auto iterations = 200000 / (1 + size / 1024);
+			sockfd_t a, b;
+			{
+				make_pair(unix_pair, a, b);
+				measure("syscall", iterations, [&] {
+					transfer(size, [&] { return static_cast<long>(send(a, out.data(), static_cast<int>(size), NO_SIGNAL)); },
+						[&](size_t n) { return static_cast<long>(recv(b, in.data(), static_cast<int>(n), 0)); });
+				});
+				close_handle(a);
+				close_handle(b);
+			}
+			{
+				make_pair(unix_pair, a, b);
+				base_socket sa(a), sb(b);
+				measure("base_socket", iterations, [&] {
+					transfer(size, [&] { return sa.base_socket::write(out.data(), size); },
+						[&](size_t n) { return sb.base_socket::read(in.data(), n); });
+				});
+			}
+			{
+				make_pair(unix_pair, a, b);
+				tcp_active_socket sa(a), sb(b);
+				bsd_adapter<tcp_active_socket> aa(sa), ab(sb);
+				//through volatile pointers, so the compiler cannot see the dynamic type and devirtualize
+				bsd_interface* volatile pa = &aa;
+				bsd_interface* volatile pb = &ab;
+				bsd_interface& ia = *pa;
+				bsd_interface& ib = *pb;
+				measure("bsd_interface", iterations, [&] {
+					transfer(size, [&] { return ia.write(out.data(), size); },
+						[&](size_t n) { return ib.read(in.data(), n); });
+				});
+			}
+			{
+				make_pair(unix_pair, a, b);
+				tcp_active_socket sa(a), sb(b);
+				measure("multi_socket", iterations, [&] {
+					transfer(size, [&] { return sa.write(out.data(), size); },
+						[&](size_t n) { return sb.read(in.data(), n); });
+				});
+				measure("std::string", iterations, [&] {
+					transfer(size, [&] { return sa.write(message); },
+						[&](size_t) { return static_cast<long>(sb.read().size()); });
+				});
+				pooled_buffer pooled;
+				measure("read_pooled", iterations, [&] {
+					transfer(size, [&] { return sa.write(out.data(), size); },
+						[&](size_t) { return read_pooled(sb, pooled); });
+				});
+				sa.write(out.data(), size);
+				measure("peek", iterations, [&] {
+					if (sb.peek() == 0) {
+						throw std::runtime_error("nothing to peek");
+					}
+				});
+				for (size_t got = 0; got < size;) {
+					got += static_cast<size_t>(sb.read(in.data(), size - got));
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief line_reads - a burst of pipelined lines, one recv a line against stream_reader serving them from large reads
+	 */
+	void line_reads(const char* name, bool unix_pair) {
+		const size_t LINES = 64;
+		for (auto size : { size_t(16), size_t(256) }) {
+			std::cout << name << " " << LINES << " x " << size << "B lines written at once, read one by one\n";
+			std::string burst;
+			for (size_t i = 0; i < LINES; ++i) {
+				burst += std::string(size - 1, 'x') + '\n';
+			}
+			std::vector<char> in(size);
+			auto iterations = 200000 / LINES;
+			sockfd_t a, b;
+			make_pair(unix_pair, a, b);
+			tcp_active_socket sa(a), sb(b);
+			measure("read per line", iterations, [&] {
+				sa.write(burst);
+				for (size_t i = 0; i < LINES; ++i) {
+					for (size_t got = 0; got < size;) {
+						got += static_cast<size_t>(sb.read(in.data() + got, size - got));
+					}
+				}
+			});
+			stream_reader<tcp_active_socket> reader(sb);
+			measure("stream_reader", iterations, [&] {
+				sa.write(burst);
+				const_buffer line;
+				for (size_t i = 0; i < LINES; ++i) {
+					if (reader.read_line(line) <= 0) {
+						throw std::runtime_error("connection closed");
+					}
+				}
+			});
+		}
+	}
+
+	void datagram_layers() {
+		for (auto size : UDP_SIZES) {
+			std::cout << "udp loopback " << size << "B write + read_from + write_back + read\n";
+			std::vector<char> out(size, 'x');
+			std::vector<char> in(size);
+			std::string message(size, 'x');
+			auto iterations = 100000;
+			//the client end is always bare handles, only the server side changes layer
+			auto client = socket(AF_INET, SOCK_DGRAM, 0);
+			auto ping = [&](unsigned short port) {
+				auto addr = loopback(port);
+				if (sendto(client, out.data(), static_cast<int>(size), 0, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != static_cast<long>(size)) {
+					throw std::runtime_error(make_error_message());
+				}
+			};
+			auto pong = [&] {
+				if (recv(client, in.data(), static_cast<int>(size), 0) <= 0) {
+					throw std::runtime_error(make_error_message());
+				}
+			};
+			{
+				auto server = socket(AF_INET, SOCK_DGRAM, 0);
+				auto addr = loopback(0);
+				if (bind(server, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == SOCKET_ERROR) {
+					throw std::runtime_error(make_error_message());
+				}
+				auto port = local_port(server);
+				measure("syscall", iterations, [&] {
+					ping(port);
+					struct sockaddr_in peer;
+					socklen_t len = sizeof(peer);
+					auto n = recvfrom(server, in.data(), static_cast<int>(size), 0, reinterpret_cast<struct sockaddr*>(&peer), &len);
+					sendto(server, in.data(), static_cast<int>(n), 0, reinterpret_cast<struct sockaddr*>(&peer), len);
+					pong();
+				});
+				close_handle(server);
+			}
+			{
+				base_socket server(AF_INET, SOCK_DGRAM, 0);
+				server.bind_to(LOOPBACK_ADDR, 0);
+				auto port = local_port(server.handle());
+				measure("base_socket", iterations, [&] {
+					ping(port);
+					auto n = server.base_socket::read_from(in.data(), size);
+					server.base_socket::write_back(in.data(), static_cast<size_t>(n));
+					pong();
+				});
+			}
+			{
+				udp_server_socket server(LOOPBACK_ADDR, 0);
+				auto port = local_port(server.handle());
+				bsd_adapter<udp_server_socket> adapter(server);
+				bsd_interface* volatile p = &adapter;
+				bsd_interface& i = *p;
+				measure("bsd_interface", iterations, [&] {
+					ping(port);
+					auto n = i.read_from(in.data(), size);
+					i.write_back(in.data(), static_cast<size_t>(n));
+					pong();
+				});
+				measure("multi_socket", iterations, [&] {
+					ping(port);
+					auto n = server.read_from(in.data(), size);
+					server.write_back(in.data(), static_cast<size_t>(n));
+					pong();
+				});
+				measure("std::string", iterations, [&] {
+					ping(port);
+					server.write_back(server.read_from());
+					pong();
+				});
+				pooled_buffer pooled;
+				measure("read_pooled", iterations, [&] {
+					ping(port);
+					read_from_pooled(server, pooled);
+					server.write_back(pooled.data(), pooled.size());
+					pong();
+				});
+				if (size > DEFAULT_BUFFER_SIZE) {
+					std::cout << "    (std::string read_from truncates datagrams to " << DEFAULT_BUFFER_SIZE << "B)\n";
+				}
+			}
+			close_handle(client);
+		}
+	}
+
+}
+
+int main() {
+
+#ifdef WIN32
+	std::cout << xsckt::startup() << "\n";
+#endif
+
+	std::cout << "sizeof base_socket " << sizeof(base_socket) << "B, tcp_active_socket " << sizeof(tcp_active_socket)
+		<< "B, bsd_adapter " << sizeof(bsd_adapter<tcp_active_socket>) << "B\n";
+
+	int status = 0;
+	try {
+#ifdef __linux__
+		stream_layers("unix socketpair", true);
+#endif
+		stream_layers("tcp loopback", false);
+#ifdef __linux__
+		line_reads("unix socketpair", true);
+#endif
+		line_reads("tcp loopback", false);
+		datagram_layers();
+	}
+	catch (std::runtime_error& e) {
+		std::cerr << e.what() << "\n";
+		status = 1;
+	}
+
+#ifdef WIN32
+	xsckt::cleanup();
+#endif
+	return status;
+
+}
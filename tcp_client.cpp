@@ -7,6 +7,7 @@
 #include <thread>
 
 #include "libxsckt/socket_factory.h"
+#include "libxsckt/message_framer.h"
 
 namespace xsckt {
 
@@ -26,6 +27,7 @@ namespace xsckt {
 		try {
 			std::cout << "attempting to connect to " << addr << ":" << port << "\n\n";
 			tcp_client_socket sckt(addr, port);
+			framed_socket<tcp_client_socket> framed(sckt);
 			std::cout << "tcp_client " << sckt.hostname() << "@" << addr << ":" << port << "\n";
 			//init handshake protocol
 			//s.write - info about client
@@ -38,12 +40,22 @@ namespace xsckt {
 						std::cin.clear();		// reset cin state
 					}
 					else {
-						sckt.write(line);
-						std::cout << sckt.read() << std::endl;
+						//the server echoes a length prefixed message at a time, however it arrives
+						framed.write(line.data(), line.size());
+						auto replied = false;
+						while (!replied) {
+							auto n = framed.read([&replied](const_buffer reply) {
+								std::cout.write(reply.data, static_cast<std::streamsize>(reply.size)) << std::endl;
+								replied = true;
+								});
+							if (n <= 0) {
+								throw std::runtime_error("server closed connection");
+							}
+						}
 					}
 				}
 			}
-			sckt.write("quit");
+			framed.write("quit", 4);
 		}
 		catch (std::runtime_error& e) {
 			std::cerr << e.what() << "\n\n";
@@ -52,6 +64,58 @@ namespace xsckt {
 		signal(SIGINT, SIG_DFL); // restore default handler
 	}
 
+	size_t tcp_echo_client::run_pipelined(std::istream& input, std::ostream& output, size_t depth) {
+		depth = depth ? depth : 1;
+		size_t replies = 0;
+		try {
+			tcp_client_socket sckt(addr, port);
+			framed_socket<tcp_client_socket> framed(sckt);
+			std::string batch;	// requests waiting to be sent, each length prefixed, reused for every batch
+			std::string line;
+			size_t in_flight = 0;
+			bool more = true;
+			while (more || in_flight > 0) {
+				//refill the window once it is half empty, rather than a line at a time, so sends are batched
+				if (more && in_flight <= depth / 2) {
+					batch.clear();
+					size_t queued = 0;
+					while (in_flight + queued < depth && !quit && std::getline(input, line)) {
+						framed.framer().frame(batch, line.data(), line.size());
+						++queued;
+					}
+					more = in_flight + queued == depth && !quit;	// stopped by the window rather than the end of input
+					for (size_t sent = 0; sent < batch.size();) {
+						auto written = sckt.write(batch.data() + sent, batch.size() - sent);
+						if (written < 0) {
+							//the socket blocks, so this is a deadline running out rather than a full buffer to wait on
+							throw std::runtime_error(would_block() ?
+								"send timed out with " + std::to_string(batch.size() - sent) + " bytes unsent" : make_error_message());
+						}
+						sent += static_cast<size_t>(written);
+					}
+					in_flight += queued;
+					if (in_flight == 0) {
+						break;
+					}
+				}
+				//one read hands over every reply it completed, in the order the requests went
+				auto n = framed.read([&](const_buffer reply) {
+					output.write(reply.data, static_cast<std::streamsize>(reply.size)).put('\n');
+					--in_flight;
+					++replies;
+					});
+				if (n <= 0) {
+					throw std::runtime_error("server closed connection with " + std::to_string(in_flight) + " requests unanswered");
+				}
+			}
+		}
+		catch (std::runtime_error& e) {
+			std::cerr << e.what() << "\n\n";
+		}
+		output.flush();
+		return replies;
+	}
+
 	void tcp_echo_client::ctrl_c(int param) {
 		std::cout << "\npress <enter> to quit" << std::endl;
 		quit = true;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <istream>
+#include <ostream>
 
 namespace xsckt {
 
@@ -10,8 +12,20 @@ namespace xsckt {
 
 		tcp_echo_client(const std::string addr, const unsigned short port);
 
+		static const size_t DEFAULT_DEPTH = 16;
+
 		void run();
 
+		/**
+		 * @brief run_pipelined - send every line of input, as a length prefixed message, with up to depth requests in flight on the one connection
+		 * Lines are queued until the window is half empty, then sent together in one write, so a batch of requests costs
+		 * one round trip and one send rather than one each. Replies come back in order and are matched to their requests
+		 * by position; each is written to output as a line.
+		 * @param depth - most requests in flight, 1 is the lockstep of run
+		 * @return size_t - number of replies
+		 */
+		size_t run_pipelined(std::istream& input, std::ostream& output, size_t depth = DEFAULT_DEPTH);
+
 	private:
 
 		const std::string addr;
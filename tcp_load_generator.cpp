@@ -0,0 +1,181 @@
+#include "tcp_load_generator.h"
+
+#include <stdexcept>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+
+#include "libxsckt/message_framer.h"
+
+namespace xsckt {
+
+	tcp_load_generator::tcp_load_generator(const options_t& options) :
+		options(options)
+	{
+		if (options.connections == 0 || options.message_size == 0 || options.depth == 0) {
+			throw std::runtime_error("tcp_load_generator: connections, message size and depth must be at least 1");
+		}
+	}
+
+	void tcp_load_generator::run() {
+		std::cout << "tcp_load_generator " << options.connections << " connections to " << options.addr << ":" << options.port
+			<< ", " << options.message_size << "B messages, ";
+		if (options.rate > 0) {
+			std::cout << "open loop " << options.rate << " msg/s per connection";
+		}
+		else {
+			std::cout << "closed loop depth " << options.depth;
+		}
+		std::cout << ", " << options.warmup << "s warm up + " << options.seconds << "s\n" << std::flush;
+
+		//connect everyone before the clock starts, so connection set up is not measured
+		std::vector<std::unique_ptr<tcp_client_socket>> sockets;
+		for (size_t i = 0; i < options.connections; ++i) {
+			sockets.push_back(std::make_unique<tcp_client_socket>(options.addr, options.port));
+			sockets.back()->no_delay();	// every message is sent as one write, Nagle would hold pipelined ones back for an ack
+		}
+		std::vector<result_t> results(options.connections);
+		auto start = clock::now();
+		measure_from = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(options.warmup));
+		measure_to = measure_from + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(options.seconds));
+
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < options.connections; ++i) {
+			threads.push_back(std::thread([this, &sckt = *sockets[i], &result = results[i]]() {
+				try {
+					if (options.rate > 0) {
+						open_loop(sckt, result);
+					}
+					else {
+						closed_loop(sckt, result);
+					}
+				}
+				catch (const std::exception& e) {
+					result.error = e.what();
+				}
+			}));
+		}
+		for (auto& t : threads) {
+			t.join();
+		}
+
+		latency_histogram latency;
+		unsigned long long messages = 0;
+		size_t failed = 0;
+		for (auto& result : results) {
+			latency.merge(result.latency);
+			messages += result.messages;
+			if (!result.error.empty()) {
+				if (failed++ == 0) {
+					std::cout << "connection failed with message:\n" << result.error << "\n";
+				}
+			}
+		}
+		auto rate = static_cast<double>(messages) / options.seconds;
+		std::cout << std::fixed << std::setprecision(1)
+			<< "throughput " << rate << " msg/s " << rate * static_cast<double>(options.message_size) / (1024 * 1024) << " MB/s echoed";
+		if (failed) {
+			std::cout << ", " << failed << " connections failed";
+		}
+		std::cout << "\nlatency " << latency.report(1000.0, "us") << std::endl;
+	}
+
+	void tcp_load_generator::closed_loop(tcp_client_socket& sckt, result_t& result) {
+		auto message = make_message();
+		std::vector<char> buffer(LARGE_BUFFER_SIZE);
+		std::deque<clock::time_point> in_flight;
+		for (size_t i = 0; i < options.depth; ++i) {
+			in_flight.push_back(clock::now());
+			write_all(sckt, message.data(), message.size());
+		}
+		size_t partial = 0;	// bytes of the oldest echo received so far
+		while (!in_flight.empty()) {
+			auto n = sckt.read(buffer.data(), buffer.size());
+			if (n <= 0) {
+				throw std::runtime_error("server closed connection");
+			}
+			partial += static_cast<size_t>(n);
+			while (partial >= message.size()) {
+				partial -= message.size();
+				auto now = clock::now();
+				if (now >= measure_from && now < measure_to) {
+					result.latency.record(static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - in_flight.front()).count()));
+					++result.messages;
+				}
+				in_flight.pop_front();
+				if (now < measure_to) {
+					in_flight.push_back(now);
+					write_all(sckt, message.data(), message.size());
+				}
+			}
+		}
+	}
+
+	void tcp_load_generator::open_loop(tcp_client_socket& sckt, result_t& result) {
+		auto interval = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / options.rate));
+		auto start = clock::now();
+		//message i is due at start + i * interval, the echoes come back in order so the receiver knows which is which
+		auto message = make_message();
+		std::thread sender([&]() {
+			try {
+				for (auto due = start; due < measure_to; due += interval) {
+					std::this_thread::sleep_until(due);
+					write_all(sckt, message.data(), message.size());
+				}
+			}
+			catch (const std::exception&) {
+				//the receiver sees the connection fail too
+			}
+			sckt.stop(action_t::WRITE);	// the server then closes, ending the receiver's reads
+		});
+		std::vector<char> buffer(LARGE_BUFFER_SIZE);
+		size_t partial = 0;
+		unsigned long long received = 0;
+		try {
+			while (true) {
+				auto n = sckt.read(buffer.data(), buffer.size());
+				if (n <= 0) {
+					break;
+				}
+				partial += static_cast<size_t>(n);
+				while (partial >= message.size()) {
+					partial -= message.size();
+					auto now = clock::now();
+					if (now >= measure_from && now < measure_to) {
+						auto due = start + interval * static_cast<long long>(received);
+						result.latency.record(static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - due).count()));
+						++result.messages;
+					}
+					++received;
+				}
+			}
+		}
+		catch (...) {
+			sender.join();
+			throw;
+		}
+		sender.join();
+	}
+
+	std::vector<char> tcp_load_generator::make_message() const {
+		std::string payload(options.message_size, 'x');
+		std::vector<char> message;
+		message_framer().frame(message, payload.data(), payload.size());
+		return message;
+	}
+
+	void tcp_load_generator::write_all(tcp_client_socket& sckt, const char* data, size_t length) {
+		for (size_t sent = 0; sent < length;) {
+			auto i = sckt.write(data + sent, length - sent);
+			if (i <= 0) {
+				throw std::runtime_error("connection closed while writing");
+			}
+			sent += static_cast<size_t>(i);
+		}
+	}
+
+}
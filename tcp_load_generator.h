@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <vector>
+
+#include "libxsckt/socket_factory.h"
+#include "libxsckt/latency_histogram.h"
+
+namespace xsckt {
+
+	/**
+	 * @brief The tcp_load_generator class drives an echo server over loopback and reports throughput and latency.
+	 * Every connection has its own thread and blocking socket. Closed loop it keeps depth messages in flight, sending the
+	 * next as each echo completes; open loop it sends at a fixed rate whatever the server does, and times each echo from
+	 * when its message was due rather than when it went, so a stalled server is not hidden by the sender stalling too.
+	 */
+	class tcp_load_generator {
+
+	public:
+
+		struct options_t {
+			std::string addr{ LOOPBACK_ADDR };
+			unsigned short port{ DEFAULT_PORT };
+			size_t connections{ 16 };
+			size_t message_size{ 64 };
+			size_t depth{ 1 };		// closed loop - messages in flight per connection
+			double rate{ 0 };		// open loop - messages a second per connection, 0 for closed loop
+			double seconds{ 10 };	// measured, after the warm up
+			double warmup{ 1 };		// echoes completing this long after the start are not counted
+		};
+
+		explicit tcp_load_generator(const options_t& options);
+
+		/**
+		 * @brief run - connect, drive the load until it ends, then print the report
+		 */
+		void run();
+
+	private:
+
+		using clock = std::chrono::steady_clock;
+
+		struct result_t {
+			latency_histogram latency;	// ns
+			unsigned long long messages{ 0 };
+			std::string error;
+		};
+
+		void closed_loop(tcp_client_socket& sckt, result_t& result);
+
+		void open_loop(tcp_client_socket& sckt, result_t& result);
+
+		/**
+		 * @brief make_message - one request as the echo server expects it, message_size bytes of payload behind its length
+		 * prefix; the echo is framed the same way, so it is as long
+		 */
+		std::vector<char> make_message() const;
+
+		/**
+		 * @brief write_all - blocking write of the whole message
+		 */
+		static void write_all(tcp_client_socket& sckt, const char* data, size_t length);
+
+		options_t options;
+		clock::time_point measure_from;
+		clock::time_point measure_to;
+
+	};
+
+}
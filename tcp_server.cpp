@@ -1,13 +1,16 @@
 #include "tcp_server.h"
 
+#include <array>
 #include <stdexcept>
-#include <algorithm>
 #include <iostream>
+#include <cstring>
 
 namespace xsckt {
 
-	tcp_server::tcp_server(const std::string addr, const unsigned short port) :
-		passive_socket(tcp_server_socket(addr, port))
+	tcp_server::tcp_server(const std::string addr, const unsigned short port, model_t model, sharing_t share) :
+		model(model),
+		transform(std::make_shared<upper_case_stage>()),
+		passive_socket(tcp_server_socket(addr, port, (model == model_t::EVENT_LOOP || model == model_t::COROUTINE) ? blocking_t::NONBLOCKING : blocking_t::BLOCKING, share))
 	{
 #ifdef VERBOSE
 		std::cout << "thread id " << std::this_thread::get_id() << " running tcp_server v0.1 " << passive_socket.hostname() << "@" << addr << ":" << port << "\n";
@@ -23,6 +26,42 @@ namespace xsckt {
 	}
 
 	void tcp_server::run() {
+		if (model == model_t::EVENT_LOOP) {
+			run_event_loop();
+		}
+		else if (model == model_t::IO_URING) {
+			run_uring();
+		}
+		else if (model == model_t::COROUTINE) {
+			run_coroutines();
+		}
+		else {
+			run_threads();
+		}
+	}
+
+	void tcp_server::set_transform(std::shared_ptr<const transform_stage> stage) {
+		transform = std::move(stage);
+	}
+
+	void tcp_server::set_idle_timeout(std::chrono::milliseconds timeout) {
+		idle_timeout = timeout;
+	}
+
+	void tcp_server::set_watermarks(size_t high, size_t low) {
+		high_watermark = high;
+		low_watermark = low;
+	}
+
+	bool tcp_server::echo(char* message, size_t length) const {
+		if (length == 4 && std::memcmp(message, "quit", 4) == 0) {
+			return false;
+		}
+		transform->apply(message, length);
+		return true;
+	}
+
+	void tcp_server::run_threads() {
 		auto server_name = passive_socket.hostname();
 
 		while (true) {
@@ -35,36 +74,379 @@ namespace xsckt {
 				throw e;
 			}
 			std::cout << "spawning...\n";
-			client_threads.push_back(std::thread([active_sockfd, server_name]() {
+			client_threads.push_back(std::thread([this, active_sockfd, server_name]() {
+				metrics::count(counter_t::CONNECTIONS_OPENED);
 				try {
 					tcp_active_socket active_sckt(active_sockfd, blocking_t::NONBLOCKING);
+					framed_socket<tcp_active_socket> framed(active_sckt);
+					std::vector<char> reply;	// the framed echoes of every message read so far
 					std::cout << "client thread " << std::this_thread::get_id() << " using active socket handle " << active_sockfd << std::endl;
+					auto last_read = std::chrono::steady_clock::now();
 					while (true) {
-						try {
-							auto line = active_sckt.read();
-							if (line == "quit") {
-								throw std::runtime_error("No error.");
+						//a read that would block ends the batch with -1 rather than throwing, anything it throws ends the client
+						long n;
+						auto quit = false;
+						auto started = metrics::now();
+						reply.clear();
+						auto on_message = [&](mutable_buffer message) {
+							if (quit) {
+								return;	// nothing after quit is answered
 							}
-							std::for_each(line.begin(), line.end(), [](char& c) {
-								c = ::toupper(c);
-								});
-							active_sckt.write(line);
-						}
-						catch (const std::exception& e) {
-							if (WSAGetLastError() != WSAEWOULDBLOCK) {
-								throw(e);
+							if (!echo(message.data, message.size)) {
+								quit = true;
+								return;
 							}
-							else {
+							framed.framer().frame(reply, message.data, message.size);
+						};
+						while ((n = framed.read(on_message)) > 0 && !quit) {}
+						//the whole batch in as few writes as a non-blocking send allows
+						for (size_t sent = 0; sent < reply.size();) {
+							auto i = active_sckt.write(reply.data() + sent, reply.size() - sent);
+							if (i < 0) {
 								std::this_thread::yield();
+								continue;
 							}
+							sent += static_cast<size_t>(i);
+						}
+						if (!reply.empty()) {
+							metrics::record_latency(metrics::now() - started);
+							last_read = std::chrono::steady_clock::now();
+						}
+						if (quit) {
+							throw std::runtime_error("No error.");
+						}
+						if (n == 0) {
+							throw std::runtime_error("client closed connection");
+						}
+						if (reply.empty()) {
+							if (idle_timeout > NO_TIMEOUT && std::chrono::steady_clock::now() - last_read > idle_timeout) {
+								throw std::runtime_error("idle timeout");
+							}
+							std::this_thread::yield();
 						}
 					}
 				}
 				catch (const std::exception& e) {
 					std::cout << "client thread " << std::this_thread::get_id() << " ended with message:\n" << e.what() << std::endl;
+#ifdef VERBOSE
+					std::cout << buffer_pool::instance().report() << metrics::report() << std::flush;
+#endif // VERBOSE
 				}
+				metrics::count(counter_t::CONNECTIONS_CLOSED);
 				}));
 		}
 	}
 
-}
\ No newline at end of file
+#ifdef __linux__
+
+	void tcp_server::run_event_loop() {
+#ifdef VERBOSE
+		std::cout << "event loop on thread " << std::this_thread::get_id() << " listening...\n" << std::endl;
+#endif // VERBOSE
+		loop.watch(passive_socket.handle(), { [this](sockfd_t) { on_accept(); }, nullptr, nullptr });
+		loop.run();
+	}
+
+	void tcp_server::on_accept() {
+		//edge triggered so drain the whole accept queue
+		sockfd_t active_sockfd;
+		while ((active_sockfd = passive_socket.accept_from()) != INVALID_SOCKET) {
+			auto& connection = connections[active_sockfd];
+			connection = std::make_unique<connection_t>(active_sockfd);
+			connection->active_sckt.no_delay();	// replies are already batched a turn at a time, Nagle would only delay them
+			connection->outbound.watermarks(high_watermark, low_watermark);
+			if (idle_timeout > NO_TIMEOUT) {
+				connection->idle = loop.timers().arm(idle_timeout, [this, active_sockfd] { on_idle(active_sockfd); });
+			}
+			loop.watch(active_sockfd, {
+				[this](sockfd_t sockfd) { on_readable(sockfd); },
+				[this](sockfd_t sockfd) { on_writable(sockfd); },
+				[this](sockfd_t sockfd) { on_closed(sockfd); }
+				});
+		}
+	}
+
+	void tcp_server::on_readable(sockfd_t sockfd) {
+		auto& connection = *connections.at(sockfd);
+		if (connection.closing) {
+			return;	// anything sent after quit or the end of the stream is not answered
+		}
+		loop.timers().rearm(connection.idle, idle_timeout);	// O(1), so once per event rather than tracking the time of every read
+		try {
+			auto drained = false;
+			while (!drained) {
+				//a client not reading its echoes is not read from either, once its queue is full the kernel's receive
+				//buffer fills in turn and TCP flow control pushes back on it, rather than its echoes piling up here
+				while (!connection.outbound.full()) {
+					//each message a read completes is echoed in place in the framer's buffer, then copied into the queue
+					//behind the earlier echoes, its prefix with it
+					auto quit = false;
+					auto n = connection.inbound.read([&](mutable_buffer message) {
+						if (quit) {
+							return;
+						}
+						auto started = metrics::now();
+						if (!echo(message.data, message.size)) {
+							quit = true;
+							return;
+						}
+						std::array<char, message_framer::MAX_PREFIX> prefix;
+						connection.outbound.write(prefix.data(), connection.inbound.framer().encode(message.size, prefix.data()));
+						connection.outbound.write(message.data, message.size);
+						metrics::record_latency(metrics::now() - started);	// to the reply being queued, it is flushed with the rest of the turn
+						});
+					if (quit || n == 0) {
+						close_after_flush(sockfd);	// quit, or orderly shutdown by the client, which may still be reading its echoes
+						return;
+					}
+					if (n < 0) {
+						drained = true;	// the turn is over
+						break;
+					}
+				}
+				//one writev for every echo of the turn, what the socket will not take yet goes on the writable event
+				connection.outbound.flush();
+				if (connection.outbound.full()) {
+					return;	// paused, on_writable resumes reading once the queue is down to the low watermark
+				}
+			}
+		}
+		catch (const std::exception& e) {
+#ifdef VERBOSE
+			std::cout << "client socket " << sockfd << " ended with message:\n" << e.what() << std::endl;
+#endif // VERBOSE
+			on_closed(sockfd);
+		}
+	}
+
+	void tcp_server::on_writable(sockfd_t sockfd) {
+		auto it = connections.find(sockfd);
+		if (it == connections.end() || it->second->outbound.empty()) {
+			return;
+		}
+		auto& connection = *it->second;
+		loop.timers().rearm(connection.idle, idle_timeout);	// a client still draining its echo is not idle
+		auto paused = connection.outbound.full();
+		try {
+			connection.outbound.flush();
+		}
+		catch (const std::exception&) {
+			on_closed(sockfd);
+			return;
+		}
+		if (connection.closing) {
+			if (connection.outbound.empty()) {
+				on_closed(sockfd);
+			}
+			return;
+		}
+		if (paused && !connection.outbound.full()) {
+			on_readable(sockfd);	// edge triggered, so nothing will announce what arrived while reading was paused
+		}
+	}
+
+	void tcp_server::on_closed(sockfd_t sockfd) {
+		auto it = connections.find(sockfd);
+		if (it != connections.end()) {
+			loop.timers().cancel(it->second->idle);
+		}
+		loop.unwatch(sockfd);
+		connections.erase(sockfd);	// closes the socket
+	}
+
+	void tcp_server::close_after_flush(sockfd_t sockfd) {
+		auto& connection = *connections.at(sockfd);
+		connection.closing = true;	// the idle timer stays armed, so a client that never reads its echoes is still closed
+		try {
+			if (connection.outbound.flush()) {
+				on_closed(sockfd);
+			}
+		}
+		catch (const std::exception&) {
+			on_closed(sockfd);
+		}
+	}
+
+	void tcp_server::on_idle(sockfd_t sockfd) {
+#ifdef VERBOSE
+		std::cout << "client socket " << sockfd << " ended with message:\nidle timeout" << std::endl;
+#endif // VERBOSE
+		on_closed(sockfd);
+	}
+
+#ifdef XSCKT_IO_URING
+
+	void tcp_server::run_uring() {
+		ring = std::make_unique<uring_loop>();
+#ifdef VERBOSE
+		std::cout << "io_uring loop on thread " << std::this_thread::get_id() << " listening...\n" << std::endl;
+#endif // VERBOSE
+		ring->accept_from(passive_socket.handle(), [this](sockfd_t sockfd) { on_ring_accept(sockfd); });
+		ring->run();
+	}
+
+	void tcp_server::on_ring_accept(sockfd_t sockfd) {
+		if (sockfd < 0) {
+			return;	// -errno, the accept stays armed
+		}
+		auto& connection = connections[sockfd];
+		connection = std::make_unique<connection_t>(sockfd);
+		auto id = connection->id = ++next_id;
+		ring->read(sockfd, [this, id](sockfd_t sockfd, const char* data, long n) { on_ring_read(sockfd, id, data, n); });
+	}
+
+	void tcp_server::on_ring_read(sockfd_t sockfd, unsigned long id, const char* data, long n) {
+		auto it = connections.find(sockfd);
+		if (it == connections.end() || it->second->id != id) {
+			return;	// a completion for an earlier connection on a reused descriptor
+		}
+		auto& connection = *it->second;
+		if (n <= 0) {
+			//end of stream or error, the read is no longer armed; a message cut short by it is dropped
+			connection.closing = true;
+			if (!connection.sending && connection.pending.empty()) {
+				connections.erase(it);
+			}
+			else {
+				ring_send(sockfd, connection);	// the socket closes once the echoes have been sent
+			}
+			return;
+		}
+		if (connection.closing) {
+			return;	// read after quit, before the end of stream
+		}
+		auto started = metrics::now();
+		//chunks end anywhere, so the framer keeps the start of a message for the next one
+		auto& framer = connection.inbound.framer();
+		framer.feed(data, static_cast<size_t>(n));
+		mutable_buffer message;
+		while (framer.next(message)) {
+			if (!echo(message.data, message.size)) {
+				connection.closing = true;
+				connection.active_sckt.stop(action_t::READ);	// the read then completes with the end of stream
+				break;
+			}
+			framer.frame(connection.pending, message.data, message.size);
+		}
+		ring_send(sockfd, connection);
+		metrics::record_latency(metrics::now() - started);	// to the reply being queued, the ring completes it later
+	}
+
+	void tcp_server::ring_send(sockfd_t sockfd, connection_t& connection) {
+		//one write in flight per connection keeps the echo in order, the rest is batched up behind it
+		if (connection.sending || connection.pending.empty()) {
+			return;
+		}
+		connection.sending = true;
+		auto id = connection.id;
+		ring->write(sockfd, std::move(connection.pending), [this, id](sockfd_t sockfd, long) {
+			auto it = connections.find(sockfd);
+			if (it != connections.end() && it->second->id == id) {
+				it->second->sending = false;
+				if (it->second->closing && it->second->pending.empty()) {
+					connections.erase(it);
+					return;
+				}
+				ring_send(sockfd, *it->second);
+			}
+			});
+		connection.pending.clear();
+	}
+
+#else
+
+	void tcp_server::run_uring() {
+		throw std::runtime_error("tcp_server io_uring model requires building with XSCKT_IO_URING");
+	}
+
+#endif // XSCKT_IO_URING
+
+#ifdef __cpp_impl_coroutine
+
+	void tcp_server::run_coroutines() {
+		scheduler = std::make_unique<async_loop>();
+#ifdef VERBOSE
+		std::cout << "coroutine loop on thread " << std::this_thread::get_id() << " listening...\n" << std::endl;
+#endif // VERBOSE
+		scheduler->spawn(accept_clients());
+		scheduler->run();
+	}
+
+	task tcp_server::accept_clients() {
+		while (true) {
+			try {
+				auto sockfd = co_await scheduler->accept(passive_socket);
+				scheduler->spawn(serve(sockfd));
+			}
+			catch (const std::exception& e) {
+				std::cout << "accept failed with message:\n" << e.what() << std::endl;	// e.g. out of file descriptors, keep listening
+			}
+		}
+	}
+
+	task tcp_server::serve(sockfd_t sockfd) {
+		tcp_active_socket active_sckt(sockfd, blocking_t::NONBLOCKING);
+		message_framer framer;
+		std::vector<char> reply;	// the framed echoes of the messages of one read
+		metrics::count(counter_t::CONNECTIONS_OPENED);
+		try {
+			auto quit = false;
+			while (!quit) {
+				//a read that times out throws, ending the client like any other error
+				auto space = framer.space();
+				auto n = co_await scheduler->read(active_sckt, space.data, space.size, 0, idle_timeout);
+				if (n == 0) {
+					break;
+				}
+				framer.commit(static_cast<size_t>(n));
+				auto started = metrics::now();
+				reply.clear();
+				//every whole message the read completed, so a pipelined batch is echoed in one write
+				mutable_buffer message;
+				while (framer.next(message)) {
+					if (!echo(message.data, message.size)) {
+						quit = true;
+						break;
+					}
+					framer.frame(reply, message.data, message.size);
+				}
+				if (!reply.empty()) {
+					co_await scheduler->write(active_sckt, reply.data(), reply.size(), 0, idle_timeout);
+					metrics::record_latency(metrics::now() - started);
+				}
+			}
+		}
+		catch (const std::exception& e) {
+#ifdef VERBOSE
+			std::cout << "client socket " << sockfd << " ended with message:\n" << e.what() << std::endl;
+#endif // VERBOSE
+		}
+		metrics::count(counter_t::CONNECTIONS_CLOSED);
+		scheduler->forget(sockfd);	// before active_sckt closes the socket
+	}
+
+#else
+
+	void tcp_server::run_coroutines() {
+		throw std::runtime_error("tcp_server coroutine model requires building as C++20");
+	}
+
+#endif // __cpp_impl_coroutine
+
+#else
+
+	void tcp_server::run_event_loop() {
+		throw std::runtime_error("tcp_server event loop model requires epoll");
+	}
+
+	void tcp_server::run_uring() {
+		throw std::runtime_error("tcp_server io_uring model requires io_uring");
+	}
+
+	void tcp_server::run_coroutines() {
+		throw std::runtime_error("tcp_server coroutine model requires epoll");
+	}
+
+#endif // __linux__
+
+}
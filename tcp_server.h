@@ -2,8 +2,22 @@
 
 #include <vector>
 #include <thread>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
 
 #include "libxsckt/socket_factory.h"
+#include "libxsckt/buffer_pool.h"
+#include "libxsckt/transform.h"
+#include "libxsckt/metrics.h"
+#include "libxsckt/write_queue.h"
+#include "libxsckt/message_framer.h"
+
+#ifdef __linux__
+#include "libxsckt/linux_event_loop.h"
+#include "libxsckt/linux_uring_loop.h"
+#include "libxsckt/linux_async.h"
+#endif
 
 #define VERBOSE
 
@@ -14,17 +28,134 @@ namespace xsckt {
 
 	public:
 
-		tcp_server(const address_t addr, const port_t port);
+		/**
+		 * @brief model_t - how client connections are served
+		 * THREAD_PER_CLIENT - a thread per accepted client polling its non-blocking socket
+		 * EVENT_LOOP - every client multiplexed on the calling thread by an edge-triggered event loop (Linux epoll only)
+		 * IO_URING - every client served on the calling thread by batched io_uring requests (Linux, built with XSCKT_IO_URING)
+		 * COROUTINE - every client a coroutine on the calling thread, resumed as its socket is ready (Linux epoll, built as C++20)
+		 */
+		enum class model_t { THREAD_PER_CLIENT, EVENT_LOOP, IO_URING, COROUTINE };
+
+		/**
+		 * @param share - REUSEPORT lets other tcp_servers listen on the same addr:port, see tcp_sharded_server
+		 */
+		tcp_server(const address_t addr, const port_t port, model_t model = model_t::THREAD_PER_CLIENT, sharing_t share = sharing_t::EXCLUSIVE);
 
 		~tcp_server();
 
 		void run();
 
+		/**
+		 * @brief set_transform - what echo does to each message before it is sent back, upper_case_stage by default
+		 * @note set it before run, the client threads share it
+		 */
+		void set_transform(std::shared_ptr<const transform_stage> stage);
+
+		/**
+		 * @brief set_idle_timeout - close a client that has sent nothing for this long, DEFAULT_IDLE_TIMEOUT by default
+		 * @param timeout - NO_TIMEOUT keeps clients however long they are silent
+		 * @note set it before run; the io_uring model does not time clients out
+		 */
+		void set_idle_timeout(std::chrono::milliseconds timeout);
+
+		/**
+		 * @brief set_watermarks - event loop model, stop reading from a client once this many echoed bytes are waiting for it
+		 * to read, and start again when it has taken them down to low; DEFAULT_HIGH_WATERMARK and DEFAULT_LOW_WATERMARK by default
+		 * @note set it before run
+		 */
+		void set_watermarks(size_t high, size_t low);
+
 	private:
 
+		/**
+		 * @brief echo - the server protocol, one length prefixed message at a time: the transform stage is applied to the
+		 * message in place, to be sent back framed the same way, and a message that is just quit ends the connection
+		 * @param message - the payload, without its prefix
+		 * @return false if the client asked to quit
+		 */
+		bool echo(char* message, size_t length) const;
+
+		void run_threads();
+
+		void run_event_loop();
+
+		void run_uring();
+
+		void run_coroutines();
+
+		model_t model;
+		std::shared_ptr<const transform_stage> transform;
+		std::chrono::milliseconds idle_timeout{ DEFAULT_IDLE_TIMEOUT };
+		size_t high_watermark{ DEFAULT_HIGH_WATERMARK };
+		size_t low_watermark{ DEFAULT_LOW_WATERMARK };
+
 		tcp_server_socket passive_socket;	// created bound and listening
 		std::vector<std::thread> client_threads;
 
+#ifdef __linux__
+
+		struct connection_t {
+			explicit connection_t(sockfd_t sockfd) : active_sckt(sockfd, blocking_t::NONBLOCKING) {
+				metrics::count(counter_t::CONNECTIONS_OPENED);
+			}
+			~connection_t() {
+				metrics::count(counter_t::CONNECTIONS_CLOSED);
+			}
+			tcp_active_socket active_sckt;
+			framed_socket<tcp_active_socket> inbound{ active_sckt };	// splits what the client sends into messages, the io_uring model feeds its framer
+			write_queue<tcp_active_socket> outbound{ active_sckt };	// event loop model - the echoes of a readable turn, flushed together
+			std::string pending;	// io_uring model - echoes waiting for the write in flight
+			bool closing{ false };	// no more reads, close once the echoes already queued have been sent
+			bool sending{ false };	// io_uring model - a write is in flight
+			unsigned long id{ 0 };	// io_uring model - tells a reused socket number from the closed connection
+			timer_handle idle;	// event loop model - closes the connection unless pushed back by activity
+		};
+
+		void on_accept();
+
+		void on_readable(sockfd_t sockfd);
+
+		void on_writable(sockfd_t sockfd);
+
+		void on_closed(sockfd_t sockfd);
+
+		/**
+		 * @brief close_after_flush - event loop model, the client has finished: send what is queued for it, then close, at
+		 * once if the socket takes it all, otherwise from on_writable once the queue has drained
+		 */
+		void close_after_flush(sockfd_t sockfd);
+
+		void on_idle(sockfd_t sockfd);
+
+		event_loop loop;
+		std::unordered_map<sockfd_t, std::unique_ptr<connection_t>> connections;
+
+#ifdef XSCKT_IO_URING
+
+		void on_ring_accept(sockfd_t sockfd);
+
+		void on_ring_read(sockfd_t sockfd, unsigned long id, const char* data, long n);
+
+		void ring_send(sockfd_t sockfd, connection_t& connection);
+
+		std::unique_ptr<uring_loop> ring;	// only set up when the model is IO_URING
+		unsigned long next_id{ 0 };
+
+#endif // XSCKT_IO_URING
+
+#ifdef __cpp_impl_coroutine
+
+		task accept_clients();
+
+		task serve(sockfd_t sockfd);
+
+		std::unique_ptr<async_loop> scheduler;	// only set up when the model is COROUTINE
+
+#endif // __cpp_impl_coroutine
+
+#endif // __linux__
+
 	};
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,38 @@
+#include "tcp_sharded_server.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <iostream>
+
+namespace xsckt {
+
+	tcp_sharded_server::tcp_sharded_server(const std::string addr, const unsigned short port, unsigned int shards) {
+		if (shards == 0) {
+			shards = std::max(1u, std::thread::hardware_concurrency());
+		}
+		for (unsigned int i = 0; i < shards; ++i) {
+			servers.push_back(std::make_unique<tcp_server>(addr, port, tcp_server::model_t::EVENT_LOOP, sharing_t::REUSEPORT));
+		}
+#ifdef VERBOSE
+		std::cout << "tcp_sharded_server " << shards << " shards @" << addr << ":" << port << "\n";
+#endif // VERBOSE
+	}
+
+	void tcp_sharded_server::run() {
+		for (auto& server : servers) {
+			auto s = server.get();
+			shard_threads.push_back(std::thread([s]() {
+				try {
+					s->run();
+				}
+				catch (const std::exception& e) {
+					std::cerr << "shard thread " << std::this_thread::get_id() << " ended with message:\n" << e.what() << std::endl;
+				}
+				}));
+		}
+		for (auto& t : shard_threads) {
+			t.join();
+		}
+	}
+
+}
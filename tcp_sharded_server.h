@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <memory>
+
+#include "tcp_server.h"
+
+namespace xsckt {
+
+	/**
+	 * @brief tcp_sharded_server - one event loop tcp_server per core, each with its own SO_REUSEPORT listening socket
+	 * The kernel spreads incoming connections across the listeners so accepts scale past a single core.
+	 * Shards share no state; a connection lives and dies on the thread that accepted it.
+	 */
+	class tcp_sharded_server {
+
+	public:
+
+		/**
+		 * @param shards - number of listener/event loop threads, 0 for one per hardware thread
+		 */
+		tcp_sharded_server(const address_t addr, const port_t port, unsigned int shards = 0);
+
+		void run();
+
+	private:
+
+		std::vector<std::unique_ptr<tcp_server>> servers;	// bound and listening before any thread starts
+		std::vector<std::thread> shard_threads;
+
+	};
+
+}